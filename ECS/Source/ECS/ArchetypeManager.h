@@ -0,0 +1,482 @@
+#pragma once
+
+#include "ECSSettings.h"
+#include "TypeList.h"
+#include "ComponentManager.h"
+
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <span>
+
+template<typename ComponentList, uint32_t Capacity = MAXENTITIES>
+class ArchetypeManager;
+
+//Stores the components of all entities with the same signature (archetype) together in fixed size chunks
+//Archetype-based ECS: iterating over a set of components walks the chunks of every matching archetype linearly, without a sparse lookup per entity
+//Adding or removing a component moves the entity with all its components to the chunks of another archetype, which makes structural changes more expensive than in the ComponentManager
+//Alternative to the ComponentManager, select it with StorageMode::Archetype on the layer
+template<typename... Component, uint32_t Capacity>
+class ArchetypeManager<ComponentList<Component...>, Capacity>
+{
+	using Components = ComponentList<Component...>;
+	using Signature = std::bitset<Count_v<Components>>;
+
+	static constexpr size_t ComponentCount = Count_v<Components>;
+	static constexpr std::array<uint32_t, ComponentCount> Sizes = { sizeof(Component)... };
+	static constexpr std::array<uint32_t, ComponentCount> Alignments = { alignof(Component)... };
+
+	//Largest row (entity + all components + alignment) that can be stored in a chunk
+	static constexpr uint32_t MaxRowSize = sizeof(Entity) + ((sizeof(Component) + alignof(Component)) + ... + 0);
+	static_assert(MaxRowSize <= ArchetypeChunkSize / 2, "Components are too large for the archetype chunk size");
+
+	//Every archetype has at most one chunk that is not full and full chunks are at least half used
+	static constexpr uint32_t MaxChunks = MaxArchetypes + (Capacity * MaxRowSize) / (ArchetypeChunkSize / 2) + 1;
+	static_assert(MaxChunks < std::numeric_limits<uint16_t>::max(), "Too many archetype chunks");
+
+	static constexpr ArchetypeType ArchetypeNull = std::numeric_limits<ArchetypeType>::max();
+
+	struct alignas(64) Chunk
+	{
+		std::array<uint8_t, ArchetypeChunkSize> Data;
+	};
+
+	//Each chunk starts with the entity array followed by one array per component of the archetype
+	struct Archetype
+	{
+		Signature ArchetypeSignature;
+		uint32_t EntityCount;
+		uint32_t RowsPerChunk;
+		uint32_t ChunkCount;
+		std::array<uint32_t, ComponentCount> Offsets;           //Offset of the component array inside a chunk
+		std::array<ArchetypeType, ComponentCount> AddEdges;     //Cached archetype that is reached by adding the component
+		std::array<ArchetypeType, ComponentCount> RemoveEdges;  //Cached archetype that is reached by removing the component
+		std::array<uint16_t, MaxChunks> Chunks;
+	};
+
+	struct EntityLocation
+	{
+		ArchetypeType ArchetypeIndex;
+		uint32_t Row;
+	};
+
+public:
+	ArchetypeManager()
+	{
+		entityLocations.fill(EntityLocation { ArchetypeNull, 0 });
+		ResetArchetypes();
+	}
+
+	//Removes all entities with their components and archetypes. Only the locations of the current entities are reset
+	void Clear()
+	{
+		ClearEntityLocations();
+		ResetArchetypes();
+	}
+
+	//Copies the archetypes and only the rows of the chunks that are in use, the cost does not scale with the capacity
+	void Overwrite(const ArchetypeManager& other)
+	{
+		ClearEntityLocations();
+
+		archetypeCount = other.archetypeCount;
+		freeChunkCount = other.freeChunkCount;
+		std::memcpy(archetypes.data(), other.archetypes.data(), archetypeCount * sizeof(Archetype));
+		std::memcpy(freeChunks.data(), other.freeChunks.data(), freeChunkCount * sizeof(uint16_t));
+
+		for (ArchetypeType archetypeIndex = 0; archetypeIndex < archetypeCount; ++archetypeIndex)
+		{
+			const Archetype& archetype = archetypes[archetypeIndex];
+
+			for (uint32_t chunk = 0; chunk < archetype.ChunkCount; ++chunk)
+			{
+				uint8_t* destination = chunks[archetype.Chunks[chunk]].Data.data();
+				const uint8_t* source = other.chunks[archetype.Chunks[chunk]].Data.data();
+				uint32_t rowCount = GetRowCount(archetype, chunk);
+
+				std::memcpy(destination, source, rowCount * sizeof(Entity));
+
+				for (ComponentType componentType = 0; componentType < ComponentCount; ++componentType)
+				{
+					if (!archetype.ArchetypeSignature.test(componentType)) continue;
+
+					uint32_t offset = archetype.Offsets[componentType];
+					std::memcpy(destination + offset, source + offset, rowCount * Sizes[componentType]);
+				}
+			}
+
+			for (uint32_t row = 0; row < archetype.EntityCount; ++row)
+			{
+				entityLocations[*GetEntityData(archetypeIndex, row)] = EntityLocation { archetypeIndex, row };
+			}
+		}
+	}
+
+	//Gets the unique component type ID for the component type T
+	template<typename T>
+	static constexpr ComponentType GetComponentType()
+	{
+		static_assert(Contains_v<T, Components>, "Component T is not part of the specified components");
+		return IndexOf_v<T, Components>;
+	}
+
+	//Adds the component of type T to the given entity by moving the entity to the archetype that includes T
+	template<typename T>
+	T* AddComponent(Entity entity, T component)
+	{
+		static_assert(!TagComponent<T>, "Tags are not stored in the archetypes, they are only part of the entity signature");
+		assert(entity < Capacity && "Entity out of range");
+		constexpr ComponentType componentType = GetComponentType<T>();
+
+		ArchetypeType archetypeIndex = entityLocations[entity].ArchetypeIndex;
+		ArchetypeType newArchetypeIndex;
+
+		if (archetypeIndex == ArchetypeNull)
+		{
+			Signature signature;
+			signature.set(componentType);
+			newArchetypeIndex = GetOrCreateArchetype(signature);
+		}
+		else
+		{
+			assert(!archetypes[archetypeIndex].ArchetypeSignature.test(componentType) && "Component added to the same entity more than once");
+			newArchetypeIndex = GetAddEdge(archetypeIndex, componentType);
+		}
+
+		MoveEntity(entity, newArchetypeIndex);
+
+		T* result = reinterpret_cast<T*>(GetComponentData(entityLocations[entity], componentType));
+		*result = component;
+		return result;
+	}
+
+	//Removes the component of type T from the given entity by moving the entity to the archetype without T
+	template<typename T>
+	void RemoveComponent(Entity entity)
+	{
+		static_assert(!TagComponent<T>, "Tags are not stored in the archetypes, they are only part of the entity signature");
+		assert(entity < Capacity && "Entity out of range");
+		assert(HasComponent<T>(entity) && "Removing a component that does not exist");
+		constexpr ComponentType componentType = GetComponentType<T>();
+
+		ArchetypeType archetypeIndex = entityLocations[entity].ArchetypeIndex;
+
+		if (archetypes[archetypeIndex].ArchetypeSignature.count() == 1)
+		{
+			//Last component of the entity
+			MoveEntity(entity, ArchetypeNull);
+		}
+		else
+		{
+			MoveEntity(entity, GetRemoveEdge(archetypeIndex, componentType));
+		}
+	}
+
+	//Gets a reference to the component of type T for the given entity
+	template<typename T>
+	inline T& GetComponent(Entity entity)
+	{
+		static_assert(!TagComponent<T>, "Tags are not stored in the archetypes, they are only part of the entity signature");
+		assert(HasComponent<T>(entity) && "Trying to get a component that does not exist");
+		return *reinterpret_cast<T*>(GetComponentData(entityLocations[entity], GetComponentType<T>()));
+	}
+
+	//Checks whether the given entity has the component of type T by checking the signature of its archetype
+	template<typename T>
+	inline bool HasComponent(Entity entity) const
+	{
+		static_assert(!TagComponent<T>, "Tags are not stored in the archetypes, they are only part of the entity signature");
+		if (entity >= Capacity) return false;
+
+		ArchetypeType archetypeIndex = entityLocations[entity].ArchetypeIndex;
+		return archetypeIndex != ArchetypeNull && archetypes[archetypeIndex].ArchetypeSignature.test(GetComponentType<T>());
+	}
+
+	//Removes all components that are associated to the given entity
+	inline void DestroyEntity(Entity entity)
+	{
+		assert(entity < Capacity && "Entity out of range");
+
+		if (entityLocations[entity].ArchetypeIndex != ArchetypeNull)
+		{
+			MoveEntity(entity, ArchetypeNull);
+		}
+	}
+
+	//Removes all components of the given entities
+	inline void DestroyEntities(std::span<const Entity> entities)
+	{
+		for (const Entity entity : entities)
+		{
+			DestroyEntity(entity);
+		}
+	}
+
+	//Calls func(entity, components&...) for every entity that has all the given components
+	//Adding or removing components during the iteration is not allowed
+	template<typename... T, typename Func>
+	void ForEach(Func&& func)
+	{
+		ForEachChunk<T...>([&func](uint32_t count, const Entity* entities, T*... components)
+		{
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				func(entities[i], components[i]...);
+			}
+		});
+	}
+
+	//Calls func(count, entities, componentArrays...) for every chunk of every archetype that has all the given components
+	template<typename... T, typename Func>
+	void ForEachChunk(Func&& func)
+	{
+		static_assert((!TagComponent<T> && ...), "Tags are not stored in the archetypes, they are only part of the entity signature");
+		constexpr Signature required = GetSignature<T...>();
+
+		for (ArchetypeType archetypeIndex = 0; archetypeIndex < archetypeCount; ++archetypeIndex)
+		{
+			const Archetype& archetype = archetypes[archetypeIndex];
+
+			if ((archetype.ArchetypeSignature & required) != required) continue;
+
+			for (uint32_t chunk = 0; chunk < archetype.ChunkCount; ++chunk)
+			{
+				uint8_t* data = chunks[archetype.Chunks[chunk]].Data.data();
+				func(GetRowCount(archetype, chunk), reinterpret_cast<const Entity*>(data), reinterpret_cast<T*>(data + archetype.Offsets[GetComponentType<T>()])...);
+			}
+		}
+	}
+
+	static constexpr size_t GetComponentCount()
+	{
+		return ComponentCount;
+	}
+
+private:
+	template<typename... T>
+	static constexpr Signature GetSignature()
+	{
+		Signature signature;
+		(signature.set(GetComponentType<T>()), ...);
+		return signature;
+	}
+
+	void ResetArchetypes()
+	{
+		archetypeCount = 0;
+		freeChunkCount = MaxChunks;
+
+		//Chunks are taken from the back, so the first chunks are used first
+		for (uint32_t i = 0; i < MaxChunks; ++i)
+		{
+			freeChunks[i] = static_cast<uint16_t>(MaxChunks - 1 - i);
+		}
+	}
+
+	//Clears the locations of the current entities
+	void ClearEntityLocations()
+	{
+		for (ArchetypeType archetypeIndex = 0; archetypeIndex < archetypeCount; ++archetypeIndex)
+		{
+			for (uint32_t row = 0; row < archetypes[archetypeIndex].EntityCount; ++row)
+			{
+				entityLocations[*GetEntityData(archetypeIndex, row)] = EntityLocation { ArchetypeNull, 0 };
+			}
+		}
+	}
+
+	inline uint32_t GetRowCount(const Archetype& archetype, uint32_t chunk) const
+	{
+		return std::min(archetype.RowsPerChunk, archetype.EntityCount - chunk * archetype.RowsPerChunk);
+	}
+
+	inline uint8_t* GetChunkData(const Archetype& archetype, uint32_t row)
+	{
+		return chunks[archetype.Chunks[row / archetype.RowsPerChunk]].Data.data();
+	}
+
+	inline Entity* GetEntityData(ArchetypeType archetypeIndex, uint32_t row)
+	{
+		const Archetype& archetype = archetypes[archetypeIndex];
+		return reinterpret_cast<Entity*>(GetChunkData(archetype, row)) + row % archetype.RowsPerChunk;
+	}
+
+	inline uint8_t* GetComponentData(EntityLocation location, ComponentType componentType)
+	{
+		const Archetype& archetype = archetypes[location.ArchetypeIndex];
+		return GetChunkData(archetype, location.Row) + archetype.Offsets[componentType] + (location.Row % archetype.RowsPerChunk) * Sizes[componentType];
+	}
+
+	ArchetypeType GetOrCreateArchetype(Signature signature)
+	{
+		for (ArchetypeType archetypeIndex = 0; archetypeIndex < archetypeCount; ++archetypeIndex)
+		{
+			if (archetypes[archetypeIndex].ArchetypeSignature == signature) return archetypeIndex;
+		}
+
+		assert(archetypeCount < MaxArchetypes && "Too many archetypes. Extend MaxArchetypes");
+
+		ArchetypeType archetypeIndex = archetypeCount++;
+		Archetype& archetype = archetypes[archetypeIndex];
+		archetype.ArchetypeSignature = signature;
+		archetype.EntityCount = 0;
+		archetype.ChunkCount = 0;
+		archetype.AddEdges.fill(ArchetypeNull);
+		archetype.RemoveEdges.fill(ArchetypeNull);
+
+		//Calculate how many rows fit into a chunk, reserving space for aligning each component array
+		uint32_t rowSize = sizeof(Entity);
+		uint32_t padding = 0;
+
+		for (ComponentType componentType = 0; componentType < ComponentCount; ++componentType)
+		{
+			if (!signature.test(componentType)) continue;
+
+			rowSize += Sizes[componentType];
+			padding += Alignments[componentType];
+		}
+
+		archetype.RowsPerChunk = (ArchetypeChunkSize - padding) / rowSize;
+
+		//The component arrays follow the entity array
+		uint32_t offset = archetype.RowsPerChunk * sizeof(Entity);
+
+		for (ComponentType componentType = 0; componentType < ComponentCount; ++componentType)
+		{
+			if (!signature.test(componentType))
+			{
+				archetype.Offsets[componentType] = 0;
+				continue;
+			}
+
+			offset = (offset + Alignments[componentType] - 1) / Alignments[componentType] * Alignments[componentType];
+			archetype.Offsets[componentType] = offset;
+			offset += archetype.RowsPerChunk * Sizes[componentType];
+		}
+
+		assert(offset <= ArchetypeChunkSize && "Archetype layout does not fit into a chunk");
+		return archetypeIndex;
+	}
+
+	ArchetypeType GetAddEdge(ArchetypeType archetypeIndex, ComponentType componentType)
+	{
+		if (archetypes[archetypeIndex].AddEdges[componentType] == ArchetypeNull)
+		{
+			Signature signature = archetypes[archetypeIndex].ArchetypeSignature;
+			signature.set(componentType);
+
+			ArchetypeType newArchetypeIndex = GetOrCreateArchetype(signature);
+			archetypes[archetypeIndex].AddEdges[componentType] = newArchetypeIndex;
+			archetypes[newArchetypeIndex].RemoveEdges[componentType] = archetypeIndex;
+		}
+
+		return archetypes[archetypeIndex].AddEdges[componentType];
+	}
+
+	ArchetypeType GetRemoveEdge(ArchetypeType archetypeIndex, ComponentType componentType)
+	{
+		if (archetypes[archetypeIndex].RemoveEdges[componentType] == ArchetypeNull)
+		{
+			Signature signature = archetypes[archetypeIndex].ArchetypeSignature;
+			signature.reset(componentType);
+
+			ArchetypeType newArchetypeIndex = GetOrCreateArchetype(signature);
+			archetypes[archetypeIndex].RemoveEdges[componentType] = newArchetypeIndex;
+			archetypes[newArchetypeIndex].AddEdges[componentType] = archetypeIndex;
+		}
+
+		return archetypes[archetypeIndex].RemoveEdges[componentType];
+	}
+
+	//Moves the entity with all components that both archetypes share to the new archetype. ArchetypeNull removes the entity from its archetype
+	void MoveEntity(Entity entity, ArchetypeType newArchetypeIndex)
+	{
+		EntityLocation location = entityLocations[entity];
+		EntityLocation newLocation { ArchetypeNull, 0 };
+
+		if (newArchetypeIndex != ArchetypeNull)
+		{
+			newLocation = EntityLocation { newArchetypeIndex, AllocateRow(newArchetypeIndex, entity) };
+
+			if (location.ArchetypeIndex != ArchetypeNull)
+			{
+				Signature sharedComponents = archetypes[location.ArchetypeIndex].ArchetypeSignature & archetypes[newArchetypeIndex].ArchetypeSignature;
+
+				for (ComponentType componentType = 0; componentType < ComponentCount; ++componentType)
+				{
+					if (!sharedComponents.test(componentType)) continue;
+
+					std::memcpy(GetComponentData(newLocation, componentType), GetComponentData(location, componentType), Sizes[componentType]);
+				}
+			}
+		}
+
+		if (location.ArchetypeIndex != ArchetypeNull)
+		{
+			RemoveRow(location.ArchetypeIndex, location.Row);
+		}
+
+		entityLocations[entity] = newLocation;
+	}
+
+	//Appends a row to the archetype, taking a new chunk when the last chunk is full
+	uint32_t AllocateRow(ArchetypeType archetypeIndex, Entity entity)
+	{
+		Archetype& archetype = archetypes[archetypeIndex];
+
+		if (archetype.EntityCount == archetype.ChunkCount * archetype.RowsPerChunk)
+		{
+			assert(freeChunkCount > 0 && "No archetype chunks left");
+			archetype.Chunks[archetype.ChunkCount++] = freeChunks[--freeChunkCount];
+		}
+
+		uint32_t row = archetype.EntityCount++;
+		*GetEntityData(archetypeIndex, row) = entity;
+
+		return row;
+	}
+
+	//Removes the row by moving the last row of the archetype into its place, which keeps the chunks dense
+	void RemoveRow(ArchetypeType archetypeIndex, uint32_t row)
+	{
+		Archetype& archetype = archetypes[archetypeIndex];
+		uint32_t lastRow = archetype.EntityCount - 1;
+
+		if (row != lastRow)
+		{
+			Entity lastEntity = *GetEntityData(archetypeIndex, lastRow);
+			*GetEntityData(archetypeIndex, row) = lastEntity;
+
+			EntityLocation location { archetypeIndex, row };
+			EntityLocation lastLocation { archetypeIndex, lastRow };
+
+			for (ComponentType componentType = 0; componentType < ComponentCount; ++componentType)
+			{
+				if (!archetype.ArchetypeSignature.test(componentType)) continue;
+
+				std::memcpy(GetComponentData(location, componentType), GetComponentData(lastLocation, componentType), Sizes[componentType]);
+			}
+
+			entityLocations[lastEntity].Row = row;
+		}
+
+		archetype.EntityCount--;
+
+		//Give the last chunk back when it is no longer used
+		if (archetype.EntityCount == (archetype.ChunkCount - 1) * archetype.RowsPerChunk)
+		{
+			freeChunks[freeChunkCount++] = archetype.Chunks[--archetype.ChunkCount];
+		}
+	}
+
+private:
+	ArchetypeType archetypeCount;
+	uint32_t freeChunkCount;
+
+	std::array<Archetype, MaxArchetypes> archetypes;
+	std::array<uint16_t, MaxChunks> freeChunks;
+	std::array<EntityLocation, Capacity> entityLocations;
+
+	std::array<Chunk, MaxChunks> chunks;
+};
@@ -0,0 +1,238 @@
+#pragma once
+
+#include "ECSSettings.h"
+#include "TypeList.h"
+#include "SparseArray.h"
+#include "ComponentManager.h"
+
+#include <array>
+#include <cassert>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+template<typename ComponentList, uint32_t Capacity = MAXENTITIES>
+class CommandBuffer;
+
+//Records structural changes (creating entities, adding and removing components and destroying entities) and applies them later in one batch with Layer::Apply
+//The commands are grouped per component collection and the systems are only updated once per entity for the removals and once for the additions
+//Recording does not touch the layer, so systems can record into their own buffer while other systems run. The buffers are applied one after another
+//Entities that are created by the buffer get a pending ID (Capacity + index) that can be used in the commands of the same buffer.
+//After the buffer has been applied, GetCreatedEntity returns the entity the pending ID was resolved to, until the next command is recorded
+//Removals of a component are applied before additions of the same component type, so removing and adding a component replaces it
+template<typename... Component, uint32_t Capacity>
+class CommandBuffer<ComponentList<Component...>, Capacity>
+{
+    using Components = ComponentList<Component...>;
+    using Signature = std::bitset<Count_v<Components>>;
+
+    template<typename T>
+    using Additions = std::vector<std::pair<Entity, T>>;
+
+public:
+    CommandBuffer() : createdCount(0), applied(false)
+    {
+        changeIndexes.Initialize();
+    }
+
+    //Reserves a pending entity that is created when the buffer is applied
+    Entity CreateEntity()
+    {
+        BeginRecording();
+        assert(Capacity + createdCount < ENTITYNULL && "Too many pending entities");
+
+        return Capacity + createdCount++;
+    }
+
+    template<typename T>
+    void AddComponent(Entity entity, T component)
+    {
+        static_assert(Contains_v<T, Components>, "Component T is not part of the specified components");
+        BeginRecording();
+        assert(IsValid(entity) && "Entity out of range");
+
+        std::get<Additions<T>>(additions).emplace_back(entity, component);
+    }
+
+    template<typename T>
+    void RemoveComponent(Entity entity)
+    {
+        static_assert(Contains_v<T, Components>, "Component T is not part of the specified components");
+        BeginRecording();
+        assert(IsValid(entity) && "Entity out of range");
+
+        removals[IndexOf_v<T, Components>].push_back(entity);
+    }
+
+    //Each entity should only be marked once
+    void MarkEntityForDestruction(Entity entity)
+    {
+        BeginRecording();
+        assert(IsValid(entity) && "Entity out of range");
+
+        destructions.push_back(entity);
+    }
+
+    bool Empty() const
+    {
+        return applied || (createdCount == 0 && destructions.empty() && (std::get<Additions<Component>>(additions).empty() && ...) &&
+                           (removals[IndexOf_v<Component, Components>].empty() && ...));
+    }
+
+    //Returns the entity that was created for the pending entity when the buffer was applied
+    Entity GetCreatedEntity(Entity pendingEntity) const
+    {
+        assert(applied && "The buffer has not been applied yet");
+        assert(IsPending(pendingEntity) && "Entity is not a pending entity of this buffer");
+
+        return createdEntities[pendingEntity - Capacity];
+    }
+
+    //Removes all commands and pending entities
+    void Clear()
+    {
+        (std::get<Additions<Component>>(additions).clear(), ...);
+
+        for (std::vector<Entity>& entities : removals)
+        {
+            entities.clear();
+        }
+
+        destructions.clear();
+        createdEntities.clear();
+        createdCount = 0;
+        applied = false;
+    }
+
+private:
+    template<typename, typename, uint32_t, StorageMode, typename>
+    friend class Layer;
+
+    //The signature change of an entity that is touched by the commands
+    struct EntityChange
+    {
+        Entity Target;
+        Signature Removed;
+        Signature Added;
+    };
+
+    inline bool IsPending(Entity entity) const
+    {
+        return entity >= Capacity && entity - Capacity < createdCount;
+    }
+
+    inline bool IsValid(Entity entity) const
+    {
+        return entity < Capacity || IsPending(entity);
+    }
+
+    inline void BeginRecording()
+    {
+        if (applied) Clear();
+    }
+
+    inline Entity Resolve(Entity entity) const
+    {
+        return IsPending(entity) ? createdEntities[entity - Capacity] : entity;
+    }
+
+    //Replaces the pending entities in all commands with the created entities
+    void ResolveEntities()
+    {
+        assert(createdEntities.size() == createdCount && "Not all pending entities have been created");
+
+        (ResolveAdditions<Component>(), ...);
+
+        for (std::vector<Entity>& entities : removals)
+        {
+            for (Entity& entity : entities)
+            {
+                entity = Resolve(entity);
+            }
+        }
+
+        for (Entity& entity : destructions)
+        {
+            entity = Resolve(entity);
+        }
+    }
+
+    template<typename T>
+    void ResolveAdditions()
+    {
+        for (std::pair<Entity, T>& addition : std::get<Additions<T>>(additions))
+        {
+            addition.first = Resolve(addition.first);
+        }
+    }
+
+    //Combines the commands into one signature change per entity, in the order in which the entities are first touched
+    void CollectChanges()
+    {
+        changes.clear();
+
+        (CollectChanges<Component>(), ...);
+
+        for (const EntityChange& change : changes)
+        {
+            changeIndexes.Reset(change.Target);
+        }
+    }
+
+    template<typename T>
+    void CollectChanges()
+    {
+        constexpr ComponentType componentType = IndexOf_v<T, Components>;
+
+        for (const Entity entity : removals[componentType])
+        {
+            GetChange(entity).Removed.set(componentType);
+        }
+
+        for (const std::pair<Entity, T>& addition : std::get<Additions<T>>(additions))
+        {
+            GetChange(addition.first).Added.set(componentType);
+        }
+    }
+
+    EntityChange& GetChange(Entity entity)
+    {
+        uint32_t index = changeIndexes.Get(entity);
+
+        if (index == ENTITYNULL)
+        {
+            index = static_cast<uint32_t>(changes.size());
+            changeIndexes.Set(entity, index);
+            changes.push_back({ entity, Signature(), Signature() });
+        }
+
+        return changes[index];
+    }
+
+    //Marks the commands as applied, the created entities stay available until the next command is recorded
+    void FinishApply()
+    {
+        (std::get<Additions<Component>>(additions).clear(), ...);
+
+        for (std::vector<Entity>& entities : removals)
+        {
+            entities.clear();
+        }
+
+        destructions.clear();
+        applied = true;
+    }
+
+private:
+    std::tuple<Additions<Component>...> additions;
+    std::array<std::vector<Entity>, Count_v<Components>> removals;
+    std::vector<Entity> destructions;
+
+    uint32_t createdCount;
+    std::vector<Entity> createdEntities;
+
+    std::vector<EntityChange> changes;
+    SparseArray<Capacity> changeIndexes;
+
+    bool applied;
+};
@@ -1,85 +1,170 @@
 #pragma once
 
 #include "ECSSettings.h"
+#include "SparseArray.h"
+#include "DenseStorage.h"
+#include "OverwriteRecord.h"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstring>
+#include <span>
+#include <utility>
+
+//Insertion sort that stops after maxSwaps swaps, so a large reorder can be spread over multiple frames
+//getKey(index) returns a comparable key and swap(index1, index2) swaps two elements. Returns true when the range is sorted
+template<typename KeyFunc, typename SwapFunc>
+bool IncrementalSort(uint32_t count, uint32_t maxSwaps, KeyFunc&& getKey, SwapFunc&& swap)
+{
+    uint32_t swaps = 0;
+
+    for (uint32_t i = 1; i < count; ++i)
+    {
+        for (uint32_t j = i; j > 0 && getKey(j) < getKey(j - 1); --j)
+        {
+            if (swaps == maxSwaps) return false;
+
+            swap(j, j - 1);
+            swaps++;
+        }
+    }
+
+    return true;
+}
+
+//Components that never change after they are added declare 'static constexpr bool Immutable = true;'
+//They are only handed out as const, so reading them never marks them as changed and overwriting their collection is skipped
+//as long as no component was added or removed. Components that cache derived data in themselves can not be immutable
+template<typename T>
+concept ImmutableComponent = requires { requires T::Immutable; };
 
 //Stores the components of type T in an array
 //Sparse set-based ECS
 //Issues: When removing components are removed the array reorders the entity indexes to make the array dense, resulting in a non-optimal order
-template<typename T>
+//The order can be restored incrementally with the Sort methods
+//The capacity is the maximum amount of entities, all entity IDs need to be smaller than the capacity
+//Every dense slot stores the version in which it was last accessed mutably, so consumers can visit only the components that changed
+//A consumer remembers the value of MarkVersion() and later calls ChangedSince with it. Versions only increase, also over Overwrite
+//Components that are moved to another slot by a removal or a swap also count as changed
+//Overwriting from the same source as last time only copies the slots that changed in one of both collections since then,
+//and is skipped completely when neither collection changed
+//Components with a field list are stored as a struct of arrays (see DenseStorage.h) and are accessed through a reference proxy or GetField
+template<typename T, uint32_t Capacity = MAXENTITIES>
 class alignas(64) ComponentCollection
 {
 	static_assert(std::is_trivially_default_constructible_v<T>, "ComponentCollection requires T to be default constructible and trivial");
 
+    using Storage = DenseStorage<T, Capacity>;
+
 public:
     inline ComponentCollection() noexcept = default;
 
     //Initializes the sparse set with null entities, to indicate that all entities have no components
     void Initialize()
     {
-        entityToIndex.fill(ENTITYNULL);
+        entityToIndex.Initialize();
         indexToEntity.fill(ENTITYNULL); //TODO can be removed also at the bottom
         entityCount = 0;
+        version = 1;
+        changedVersion = version;
+        storageId = NextStorageId();
+        record.Reset();
     }
 
-    //Adds the component of type T to the given entity
-    T* AddComponent(Entity entity, T component)
+    //Adds the component of type T to the given entity. Returns a pointer to the component, or a reference proxy for components with a field list
+    auto AddComponent(Entity entity, T component)
     {
-        assert(entity < MAXENTITIES && "Entity out of range");
-        assert(entityToIndex[entity] == ENTITYNULL&& "Component added to the same entity more than once. Use MultiComponentArray instead");
+        assert(entity < Capacity && "Entity out of range");
+        assert(entityToIndex.Get(entity) == ENTITYNULL&& "Component added to the same entity more than once. Use MultiComponentArray instead");
 
         //New index is the next available index in the component list
         std::int32_t entityIndex = entityCount;
 
         //Render the maps and assign the component
-        entityToIndex[entity] = entityIndex;
+        entityToIndex.Set(entity, entityIndex);
         indexToEntity[entityIndex] = entity;
 
         //Store the component
-        components[entityIndex] = component;
+        components.Set(entityIndex, component);
+        versions[entityIndex] = version;
+        changedVersion = version;
         entityCount++;
 
-    	return &components[entityIndex];
+    	return components.GetPointer(entityIndex);
+    }
+
+    //Adds the same component to all given entities with one append to the dense arrays
+    void AddComponents(std::span<const Entity> entities, const T& component)
+    {
+        assert(entityCount + entities.size() <= Capacity && "Too many components");
+
+        for (const Entity entity : entities)
+        {
+            assert(entity < Capacity && "Entity out of range");
+            assert(entityToIndex.Get(entity) == ENTITYNULL && "Component added to the same entity more than once");
+
+            entityToIndex.Set(entity, entityCount);
+            indexToEntity[entityCount] = entity;
+            components.Set(entityCount, component);
+            versions[entityCount] = version;
+            entityCount++;
+        }
+
+        changedVersion = version;
     }
 
     //Removes the component from the given entity
     void RemoveComponent(Entity entity)
     {
-        assert(entity < MAXENTITIES && "Entity out of range");
-        assert(entityToIndex[entity] != ENTITYNULL && "Removing a component that does not exist");
+        assert(entity < Capacity && "Entity out of range");
+        assert(entityToIndex.Get(entity) != ENTITYNULL && "Removing a component that does not exist");
 
-        uint32_t indexOfRemovedEntity = entityToIndex[entity];
+        uint32_t indexOfRemovedEntity = entityToIndex.Get(entity);
         uint32_t lastEntityIndex = entityCount - 1; //TODO: range exception
 
         //Move the last component to the index of the removed entity
-        components[indexOfRemovedEntity] = components[lastEntityIndex];
+        components.Move(lastEntityIndex, indexOfRemovedEntity);
+        versions[indexOfRemovedEntity] = version;
+        changedVersion = version;
         Entity entityOfLastIndex = indexToEntity[lastEntityIndex];
 
         //Update the sparse set
-        entityToIndex[entityOfLastIndex] = indexOfRemovedEntity;
+        entityToIndex.Set(entityOfLastIndex, indexOfRemovedEntity);
         indexToEntity[indexOfRemovedEntity] = entityOfLastIndex;
 
         //Set the now invalid index to NULL
-        entityToIndex[entity] = ENTITYNULL;
+        entityToIndex.Reset(entity);
         indexToEntity[lastEntityIndex] = ENTITYNULL;
 
         entityCount--;
     }
 
-    //Gets a reference to the component for the given entity
-    T& GetComponent(Entity entity)
+    //Gets a reference to the component for the given entity and marks the component as changed
+    //Components with a field list return a reference proxy
+    typename Storage::Reference GetComponent(Entity entity) requires (!ImmutableComponent<T>)
+    {
+        assert(entity < Capacity);
+        assert(entityToIndex.Get(entity) != ENTITYNULL && "Trying to get a component that does not exist");
+
+        uint32_t index = entityToIndex.Get(entity);
+        versions[index] = version;
+        changedVersion = version;
+        return components.Get(index);
+    }
+
+    //Gets a read only reference to the component for the given entity, without marking it as changed
+    typename Storage::ConstReference GetComponent(Entity entity) const
     {
-        assert(entity < MAXENTITIES);
-        assert(entityToIndex[entity] != ENTITYNULL && "Trying to get a component that does not exist");
-        return components[entityToIndex[entity]];
+        assert(entity < Capacity);
+        assert(entityToIndex.Get(entity) != ENTITYNULL && "Trying to get a component that does not exist");
+        return components.Get(entityToIndex.Get(entity));
     }
 
     //Checks whether the given entity has the component by checking the sparse set for entity null
     bool HasComponent(Entity entity) const
     {
-        return entity < MAXENTITIES && entityToIndex[entity] != ENTITYNULL;
+        return entity < Capacity && entityToIndex.Get(entity) != ENTITYNULL;
     }
 
     //Returns the entity count (all entities that have this component type attached)
@@ -88,31 +173,271 @@ public:
         return entityCount;
     }
 
+    //Gets the dense index of the component of the given entity
+    uint32_t GetIndex(Entity entity) const
+    {
+        assert(HasComponent(entity) && "Trying to get the index of a component that does not exist");
+        return entityToIndex.Get(entity);
+    }
+
+    //Swaps two components in the dense array, used to reorder the collection
+    void SwapIndexes(uint32_t index1, uint32_t index2)
+    {
+        assert(index1 < entityCount && index2 < entityCount && "Index out of range");
+
+        if (index1 == index2) return;
+
+        components.Swap(index1, index2);
+        versions[index1] = version;
+        versions[index2] = version;
+        changedVersion = version;
+        std::swap(indexToEntity[index1], indexToEntity[index2]);
+
+        entityToIndex.Set(indexToEntity[index1], index1);
+        entityToIndex.Set(indexToEntity[index2], index2);
+    }
+
+    //Incrementally sorts the dense array by getKey(entity, component) with at most maxSwaps swaps. Returns true when the collection is sorted
+    //Collections that are owned by a group need to be sorted through the group
+    template<typename KeyFunc>
+    bool Sort(KeyFunc&& getKey, uint32_t maxSwaps)
+    {
+        return IncrementalSort(entityCount, maxSwaps,
+            [&](uint32_t index) { return getKey(indexToEntity[index], components.Get(index)); },
+            [this](uint32_t index1, uint32_t index2) { SwapIndexes(index1, index2); });
+    }
+
+    //Incrementally sorts the dense array by entity ID
+    bool SortByEntity(uint32_t maxSwaps)
+    {
+        return Sort([](Entity entity, const T&) { return entity; }, maxSwaps);
+    }
+
+    //Incrementally sorts the dense array in the order of the other collection. Entities that are not part of the other collection are moved to the back
+    template<typename U>
+    bool SortAs(const ComponentCollection<U, Capacity>* other, uint32_t maxSwaps)
+    {
+        return Sort([other](Entity entity, const T&) { return other->HasComponent(entity) ? other->GetIndex(entity) : ENTITYNULL; }, maxSwaps);
+    }
+
+    //Returns the entities in the dense order of the components
+    const Entity* GetEntities() const
+    {
+        return indexToEntity.data();
+    }
+
+    //Returns the current version, components that are accessed mutably get this version
+    uint32_t GetVersion() const
+    {
+        return version;
+    }
+
+    //Returns the current version and starts a new one. Changes after this call are visible with ChangedSince(returned version)
+    uint32_t MarkVersion()
+    {
+        return version++;
+    }
+
+    //Marks the component of the entity as changed without accessing it
+    void MarkChanged(Entity entity)
+    {
+        assert(HasComponent(entity) && "Trying to mark a component that does not exist");
+        versions[entityToIndex.Get(entity)] = version;
+        changedVersion = version;
+    }
+
+    //Marks count components starting at the dense index as changed, used when the dense array is handed out mutably
+    void MarkIndexesChanged(uint32_t firstIndex, uint32_t count)
+    {
+        assert(firstIndex + count <= entityCount && "Index out of range");
+        std::fill_n(versions.data() + firstIndex, count, version);
+        changedVersion = version;
+    }
+
+    //Checks whether the component of the entity changed after the given version
+    bool HasChangedSince(Entity entity, uint32_t sinceVersion) const
+    {
+        return versions[GetIndex(entity)] > sinceVersion;
+    }
+
+    //Calls func(entity, const component&) for every component that changed after the given version
+    template<typename Func>
+    void ChangedSince(uint32_t sinceVersion, Func&& func) const
+    {
+        for (uint32_t i = 0; i < entityCount; ++i)
+        {
+            if (versions[i] > sinceVersion)
+            {
+                func(indexToEntity[i], components.Get(i));
+            }
+        }
+    }
+
+    //Returns the dense component array, only the first GetEntityCount() components are valid
+    //Writing through this array does not mark the components as changed, use MarkIndexesChanged for that
+    T* GetComponents() requires (!HasFieldList<T> && !ImmutableComponent<T>)
+    {
+        return components.Data();
+    }
+
+    const T* GetComponents() const requires (!HasFieldList<T>)
+    {
+        return components.Data();
+    }
+
+    //Returns the dense array of a single field of components with a field list and marks all components as changed
+    template<auto Member>
+    std::span<typename MemberTraits<Member>::Type> GetField() requires (HasFieldList<T> && !ImmutableComponent<T>)
+    {
+        MarkIndexesChanged(0, entityCount);
+        return { components.template GetField<Member>(), entityCount };
+    }
+
+    template<auto Member>
+    std::span<const typename MemberTraits<Member>::Type> GetField() const requires HasFieldList<T>
+    {
+        return { components.template GetField<Member>(), entityCount };
+    }
+
     //Removes the component from the entity if possible
     void DestroyEntity(Entity entity)
     {
-        assert(entity < MAXENTITIES && "Entity out of range");
+        assert(entity < Capacity && "Entity out of range");
 
-        if (entityToIndex[entity] != ENTITYNULL)
+        if (entityToIndex.Get(entity) != ENTITYNULL)
         {
             RemoveComponent(entity);
         }
     }
 
-    void Overwrite(ComponentCollection* other)
+    //Removes the components of all given entities that have one
+    void DestroyEntities(std::span<const Entity> entities)
+    {
+        for (const Entity entity : entities)
+        {
+            DestroyEntity(entity);
+        }
+    }
+
+    //Removes all components. Only the entries of the current entities are reset, so the cost does not scale with the capacity
+    void Clear()
+    {
+        for (uint32_t i = 0; i < entityCount; ++i)
+        {
+            entityToIndex.Reset(indexToEntity[i]);
+            indexToEntity[i] = ENTITYNULL;
+        }
+
+        entityCount = 0;
+        changedVersion = version;
+    }
+
+    //Copies the other collection. When the last overwrite was done from the same collection, only the slots that changed in one of
+    //both collections since then are copied. Otherwise the used part is copied, so the cost never scales with the capacity
+    //All copied components are marked as changed in the current version, the versions of the other collection are not copied
+    void Overwrite(const ComponentCollection* other)
+    {
+        if (record.IsFrom(other->storageId))
+        {
+            if (!record.IsUnchanged(other->storageId, other->changedVersion, changedVersion))
+            {
+                OverwriteChanged(other);
+            }
+        }
+        else
+        {
+            OverwriteAll(other);
+        }
+
+        record = { other->storageId, other->version++, version++ };
+    }
+
+private:
+    void OverwriteAll(const ComponentCollection* other)
+    {
+        //Clear the sparse set entries of the current entities
+        for (uint32_t i = 0; i < entityCount; ++i)
+        {
+            entityToIndex.Reset(indexToEntity[i]);
+            indexToEntity[i] = ENTITYNULL;
+        }
+
+        entityCount = other->entityCount;
+        components.CopyRange(other->components, entityCount);
+        std::memcpy(indexToEntity.data(), other->indexToEntity.data(), entityCount * sizeof(Entity));
+
+        for (uint32_t i = 0; i < entityCount; ++i)
+        {
+            entityToIndex.Set(indexToEntity[i], i);
+        }
+
+        std::fill_n(versions.data(), entityCount, version);
+        changedVersion = version;
+    }
+
+    void OverwriteChanged(const ComponentCollection* other)
     {
-        std::memcpy(&components, &other->components, sizeof(std::array<T, MAXENTITIES>));
-        indexToEntity = other->indexToEntity;
-        entityToIndex = other->entityToIndex;
+        const uint32_t commonCount = std::min(entityCount, other->entityCount);
+
+        for (uint32_t i = 0; i < commonCount; ++i)
+        {
+            if (other->versions[i] > record.SourceVersion || versions[i] > record.Version)
+            {
+                CopySlot(other, i);
+            }
+        }
+
+        //Slots that only exist in one of both collections always changed
+        for (uint32_t i = commonCount; i < other->entityCount; ++i)
+        {
+            CopySlot(other, i);
+        }
+
+        for (uint32_t i = other->entityCount; i < entityCount; ++i)
+        {
+            ResetSlot(i);
+        }
+
         entityCount = other->entityCount;
+        changedVersion = version;
+    }
+
+    inline void CopySlot(const ComponentCollection* other, uint32_t index)
+    {
+        ResetSlot(index);
+
+        const Entity entity = other->indexToEntity[index];
+        components.Copy(other->components, index);
+        indexToEntity[index] = entity;
+        entityToIndex.Set(entity, index);
+        versions[index] = version;
+    }
+
+    //The entity of the slot can already be moved to another slot by an earlier copy, then its sparse entry is kept
+    inline void ResetSlot(uint32_t index)
+    {
+        const Entity entity = indexToEntity[index];
+
+        if (entity != ENTITYNULL && entityToIndex.Get(entity) == index)
+        {
+            entityToIndex.Reset(entity);
+        }
+
+        indexToEntity[index] = ENTITYNULL;
     }
 
 private:
-    std::array<T, MAXENTITIES> components;
-    std::array<Entity, MAXENTITIES> indexToEntity;
-    std::array<std::uint32_t, MAXENTITIES> entityToIndex;
+    Storage components;
+    std::array<Entity, Capacity> indexToEntity;
+    std::array<uint32_t, Capacity> versions;
+    SparseArray<Capacity> entityToIndex;
 
     std::uint32_t entityCount;
+    mutable std::uint32_t version;     //Also advanced by the collections that overwrite themselves with this collection
+    std::uint32_t changedVersion;      //Version of the last change of any slot
+
+    uint64_t storageId;
+    OverwriteRecord record;
 };
 
 static_assert(std::is_trivially_default_constructible_v<ComponentCollection<bool>>, "Component Collection needs to be trivial");
\ No newline at end of file
@@ -3,23 +3,41 @@
 #include "ECSSettings.h"
 #include "TypeList.h"
 #include "ComponentCollection.h"
+#include "ComponentView.h"
+#include "OwningGroup.h"
 
 #include <array>
 #include <cassert>
 #include <cstring>
+#include <span>
+#include <type_traits>
 
 template<typename... Component>
 using ComponentList = TypeList<Component...>;
 
-template<typename ComponentList>
+//Components without data are tags. A tag is only stored as a bit in the entity signature and has no component collection
+//Adding and removing a tag only changes the signature and the systems, which is cheaper than inserting into a collection
+template<typename T>
+concept TagComponent = std::is_empty_v<T>;
+
+template<typename ComponentList, uint32_t Capacity = MAXENTITIES>
 class ComponentManager;
 
 //Manages all component collections and uses the component name for easy lookups
-template<typename... Component>
-class ComponentManager<ComponentList<Component...>>
+template<typename... Component, uint32_t Capacity>
+class ComponentManager<ComponentList<Component...>, Capacity>
 {
 	using Components = ComponentList<Component...>;
 
+	template<typename T>
+	using Collection = ComponentCollection<T, Capacity>;
+
+	//Placeholder that keeps the offsets indexed by the component type
+	struct TagStorage { };
+
+	template<typename T>
+	using Storage = std::conditional_t<TagComponent<T>, TagStorage, Collection<T>>;
+
 public:
 	ComponentManager()
 	{
@@ -28,12 +46,20 @@ public:
 
 	~ComponentManager()
 	{
-		(GetComponentCollection<Component>()->~ComponentCollection<Component>(), ...);
+		(UnregisterComponent<Component>(), ...);
 	}
 
+	//Overwrites each collection, which only copies the used part of the collections
+	//Collections that did not change since the last overwrite from the same manager are skipped, which keeps immutable components out of repeated snapshots
 	inline void Overwrite(const ComponentManager& other)
 	{
-		std::memcpy(Data.data(), other.Data.data(), sizeof(Data));
+		(OverwriteComponent<Component>(other), ...);
+	}
+
+	//Removes all components of all entities
+	inline void Clear()
+	{
+		(ClearComponent<Component>(), ...);
 	}
 
     //Gets the unique component type ID for the component type T
@@ -46,12 +72,20 @@ public:
 
     //Adds the component of type T to the given entity
 	template<typename T>
-	inline T* AddComponent(Entity entity, T component)
+	inline auto AddComponent(Entity entity, T component)
 	{
 		static_assert(Contains_v<T, Components>, "Component T is not part of the specified components");
         return GetComponentCollection<T>()->AddComponent(entity, component);
 	}
 
+    //Adds the same component of type T to all given entities
+	template<typename T>
+	inline void AddComponents(std::span<const Entity> entities, const T& component)
+	{
+		static_assert(Contains_v<T, Components>, "Component T is not part of the specified components");
+        GetComponentCollection<T>()->AddComponents(entities, component);
+	}
+
     //Removes the component of type T from the given entity
     template<typename T>
     inline void RemoveComponent(Entity entity)
@@ -62,7 +96,7 @@ public:
 
     //Gets a reference to the component of type T for the given entity
     template<typename T>
-	inline T& GetComponent(Entity entity)
+	inline decltype(auto) GetComponent(Entity entity)
 	{
 		static_assert(Contains_v<T, Components>, "Component T is not part of the specified components");
         return GetComponentCollection<T>()->GetComponent(entity);
@@ -82,12 +116,41 @@ public:
 		(DestroyEntityForComponent<Component>(entity), ...);
 	}
 
+    //Removes all components of the given entities with one pass over the entities per collection
+	inline void DestroyEntities(std::span<const Entity> entities)
+	{
+		(DestroyEntitiesForComponent<Component>(entities), ...);
+	}
+
 	//Gets the component collection for a specific component of type T
 	template<typename T>
-	inline constexpr ComponentCollection<T>* GetComponentCollection()
+	inline constexpr Collection<T>* GetComponentCollection()
+	{
+		static_assert(Contains_v<T, Components>, "Component T is not part of the specified components");
+		static_assert(!TagComponent<T>, "Tags have no component collection, they are only part of the entity signature");
+		return reinterpret_cast<Collection<T>*>(&Data[ComponentOffset<T>]);
+	}
+
+	template<typename T>
+	inline constexpr const Collection<T>* GetComponentCollection() const
 	{
 		static_assert(Contains_v<T, Components>, "Component T is not part of the specified components");
-		return reinterpret_cast<ComponentCollection<T>*>(&Data[ComponentOffset<T>]);
+		static_assert(!TagComponent<T>, "Tags have no component collection, they are only part of the entity signature");
+		return reinterpret_cast<const Collection<T>*>(&Data[ComponentOffset<T>]);
+	}
+
+	//Creates a view over all entities that have all the given components
+	template<typename... T>
+	inline ComponentView<Capacity, T...> View()
+	{
+		return ComponentView<Capacity, T...>(GetComponentCollection<std::remove_const_t<T>>()...);
+	}
+
+	//Creates a group that owns the given components. Declare it as member 'Group' of a system
+	template<typename... T>
+	inline OwningGroup<Capacity, T...> Group()
+	{
+		return OwningGroup<Capacity, T...>(GetComponentCollection<T>()...);
 	}
 
 	static constexpr size_t GetComponentCount()
@@ -99,24 +162,66 @@ private:
 	template<typename T>
 	inline void RegisterComponent()
 	{
-		ComponentCollection<T>* collection = new (&Data[ComponentOffset<T>]) ComponentCollection<T>();
-		collection->Initialize();
+		if constexpr (!TagComponent<T>)
+		{
+			Collection<T>* collection = new (&Data[ComponentOffset<T>]) Collection<T>();
+			collection->Initialize();
+		}
+	}
+
+	template<typename T>
+	inline void UnregisterComponent()
+	{
+		if constexpr (!TagComponent<T>)
+		{
+			GetComponentCollection<T>()->~Collection<T>();
+		}
+	}
+
+	template<typename T>
+	inline void OverwriteComponent(const ComponentManager& other)
+	{
+		if constexpr (!TagComponent<T>)
+		{
+			GetComponentCollection<T>()->Overwrite(other.template GetComponentCollection<T>());
+		}
+	}
+
+	template<typename T>
+	inline void ClearComponent()
+	{
+		if constexpr (!TagComponent<T>)
+		{
+			GetComponentCollection<T>()->Clear();
+		}
 	}
 
 	template<typename T>
 	inline void DestroyEntityForComponent(Entity entity)
 	{
-		reinterpret_cast<ComponentCollection<T>*>(&Data[ComponentOffset<T>])->DestroyEntity(entity);
+		if constexpr (!TagComponent<T>)
+		{
+			GetComponentCollection<T>()->DestroyEntity(entity);
+		}
+	}
+
+	template<typename T>
+	inline void DestroyEntitiesForComponent(std::span<const Entity> entities)
+	{
+		if constexpr (!TagComponent<T>)
+		{
+			GetComponentCollection<T>()->DestroyEntities(entities);
+		}
 	}
 
 private:
 	static constexpr size_t ComponentCount = Count_v<Components>;
-	static constexpr size_t TotalSize = TotalSize_v<ComponentCollection<Component>...>;
+	static constexpr size_t TotalSize = TotalSize_v<Storage<Component>...>;
 
-	static constexpr std::array<size_t, ComponentCount> Offsets = GetOffsets<ComponentCollection<Component>...>();
+	static constexpr std::array<size_t, ComponentCount> Offsets = GetOffsets<Storage<Component>...>();
 
 	template<typename T>
 	static constexpr std::size_t ComponentOffset = Offsets[GetComponentType<T>()];
 
-	std::array<uint8_t, TotalSize> Data;
+	alignas(64) std::array<uint8_t, TotalSize> Data;
 };
\ No newline at end of file
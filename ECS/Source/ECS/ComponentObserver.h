@@ -0,0 +1,182 @@
+#pragma once
+
+#include "ECSSettings.h"
+#include "TypeList.h"
+
+#include <array>
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+//Collects the entities that got or lost a component type since the last clear, instead of calling a callback for every change
+//The lists only hold the net changes: an entity that got the component and lost it again is in neither list,
+//an entity that lost the component and got it again is in both lists. Process the removed entities before the added entities
+//The observer is not part of the layer state. When the layer is overwritten or cleared the lists are dropped and the observer is marked as reset,
+//then the observed state needs to be rebuilt from the layer
+template<uint32_t Capacity>
+class ComponentObserver
+{
+public:
+    //The observer only allocates when it is enabled, so unobserved component types do not use any memory
+    void Enable()
+    {
+        if (enabled) return;
+
+        addedIndexes.assign(Capacity, InvalidIndex);
+        enabled = true;
+        reset = true;
+    }
+
+    inline bool IsEnabled() const
+    {
+        return enabled;
+    }
+
+    void Added(Entity entity)
+    {
+        assert(entity < Capacity && "Entity out of range");
+        assert(addedIndexes[entity] == InvalidIndex && "Entity already got the component");
+
+        addedIndexes[entity] = static_cast<uint32_t>(added.size());
+        added.push_back(entity);
+    }
+
+    void Removed(Entity entity)
+    {
+        assert(entity < Capacity && "Entity out of range");
+
+        const uint32_t index = addedIndexes[entity];
+
+        //The entity got the component after the last clear, so the change cancels out
+        if (index != InvalidIndex)
+        {
+            const Entity last = added.back();
+            added[index] = last;
+            addedIndexes[last] = index;
+            added.pop_back();
+            addedIndexes[entity] = InvalidIndex;
+            return;
+        }
+
+        removed.push_back(entity);
+    }
+
+    //Drops the lists, the state of the layer was replaced as a whole
+    void Reset()
+    {
+        Clear();
+        reset = true;
+    }
+
+    //Drops the lists after they have been processed, usually once per frame
+    void Clear()
+    {
+        for (const Entity entity : added)
+        {
+            addedIndexes[entity] = InvalidIndex;
+        }
+
+        added.clear();
+        removed.clear();
+        reset = false;
+    }
+
+    //Entities that have the component now, but did not have it at the last clear
+    std::span<const Entity> GetAdded() const
+    {
+        return added;
+    }
+
+    //Entities that had the component at the last clear, but lost it since then
+    std::span<const Entity> GetRemoved() const
+    {
+        return removed;
+    }
+
+    //Whether the layer was overwritten or cleared since the last clear. The lists do not describe that change, so everything needs to be rebuilt
+    bool WasReset() const
+    {
+        return reset;
+    }
+
+private:
+    static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+    std::vector<Entity> added;
+    std::vector<Entity> removed;
+    std::vector<uint32_t> addedIndexes;
+    bool enabled = false;
+    bool reset = false;
+};
+
+template<typename ComponentList, uint32_t Capacity>
+class ObserverManager;
+
+//Holds an observer for every component type and forwards the signature changes of the layer to the observed component types
+template<typename... Component, uint32_t Capacity>
+class ObserverManager<ComponentList<Component...>, Capacity>
+{
+    static constexpr ComponentType ComponentCount = sizeof...(Component);
+    using Signature = std::bitset<ComponentCount>;
+
+public:
+    ComponentObserver<Capacity>& Observe(ComponentType componentType)
+    {
+        observers[componentType].Enable();
+        observed.set(componentType);
+        return observers[componentType];
+    }
+
+    const ComponentObserver<Capacity>& GetObserver(ComponentType componentType) const
+    {
+        return observers[componentType];
+    }
+
+    //Only the components that are observed are checked, so the cost is a single mask test when nothing is observed
+    inline void SignatureChanged(Entity entity, Signature oldSignature, Signature newSignature)
+    {
+        const Signature changed = (oldSignature ^ newSignature) & observed;
+
+        if (changed.none()) return;
+
+        for (ComponentType componentType = 0; componentType < ComponentCount; ++componentType)
+        {
+            if (!changed.test(componentType)) continue;
+
+            if (newSignature.test(componentType))
+            {
+                observers[componentType].Added(entity);
+            }
+            else
+            {
+                observers[componentType].Removed(entity);
+            }
+        }
+    }
+
+    void Reset()
+    {
+        if (observed.none()) return;
+
+        for (ComponentObserver<Capacity>& observer : observers)
+        {
+            if (observer.IsEnabled()) observer.Reset();
+        }
+    }
+
+    void Clear()
+    {
+        if (observed.none()) return;
+
+        for (ComponentObserver<Capacity>& observer : observers)
+        {
+            if (observer.IsEnabled()) observer.Clear();
+        }
+    }
+
+private:
+    std::array<ComponentObserver<Capacity>, ComponentCount> observers;
+    Signature observed;
+};
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "ECSSettings.h"
+#include "ComponentCollection.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+//Iterates over all entities that have all components T of a view and gives direct references to the components
+//When all collections store the entities in the same dense order the components are walked as parallel arrays
+//Otherwise the smallest collection drives the iteration and the other collections are looked up through their sparse sets
+//Adding or removing components of the viewed types during the iteration is not allowed
+//Components of a non-const type are handed out mutably, so they are marked as changed in their collections
+//Components of a const type (View<Transform, const Movable>) are only read, which keeps them unchanged and allows other readers at the same time
+template<uint32_t Capacity, typename... T>
+class ComponentView
+{
+    static_assert(sizeof...(T) > 0, "A view needs at least one component type");
+    static_assert((!HasFieldList<std::remove_const_t<T>> && ...), "Components with a field list can not be viewed, use GetField of the collection instead");
+    static_assert(((std::is_const_v<T> || !ImmutableComponent<T>) && ...), "Immutable components can only be viewed as const");
+
+    using Indices = std::index_sequence_for<T...>;
+
+    template<typename U>
+    using Collection = std::conditional_t<std::is_const_v<U>, const ComponentCollection<std::remove_const_t<U>, Capacity>, ComponentCollection<U, Capacity>>;
+
+public:
+    explicit ComponentView(Collection<T>*... collections) : collections(collections...) { }
+
+    //Calls func(entity, components&...) for every entity that has all components of the view
+    template<typename Func>
+    void ForEach(Func&& func) const
+    {
+        if (SharesOrdering())
+        {
+            ForEachDense(func, 0, std::get<0>(collections)->GetEntityCount(), Indices());
+            MarkChanged(Indices());
+        }
+        else
+        {
+            ForEachFromSmallest(func, [](uint32_t count, auto&& forRange) { forRange(0u, count); }, Indices());
+        }
+    }
+
+    //Calls func(entity, components&...) like ForEach, split over the thread pool in chunks of ParallelChunkSize of the driving collection
+    //func should only write the components of its own entity, then the result is the same as ForEach
+    //The workers only reach the components through their dense index, the visited components are marked as changed after all chunks are done
+    template<typename Func>
+    void ForEachParallel(ThreadPool& threadPool, Func&& func) const
+    {
+        if (SharesOrdering())
+        {
+            threadPool.ParallelFor(std::get<0>(collections)->GetEntityCount(), ParallelChunkSize, [this, &func](uint32_t begin, uint32_t end)
+            {
+                ForEachDense(func, begin, end, Indices());
+            });
+
+            MarkChanged(Indices());
+        }
+        else
+        {
+            ForEachFromSmallest(func, [&threadPool](uint32_t count, auto&& forRange) { threadPool.ParallelFor(count, ParallelChunkSize, forRange); }, Indices());
+        }
+    }
+
+    //Checks whether all collections contain the same entities in the same dense order
+    bool SharesOrdering() const
+    {
+        return SharesOrdering(Indices());
+    }
+
+    //Returns the maximum amount of entities the view can visit
+    uint32_t SizeHint() const
+    {
+        return std::apply([](const auto*... collection) { return std::min({ collection->GetEntityCount()... }); }, collections);
+    }
+
+private:
+    template<size_t... I>
+    bool SharesOrdering(std::index_sequence<I...>) const
+    {
+        const uint32_t count = std::get<0>(collections)->GetEntityCount();
+        const Entity* entities = std::get<0>(collections)->GetEntities();
+
+        return ((std::get<I>(collections)->GetEntityCount() == count) && ...) &&
+               ((I == 0 || std::memcmp(std::get<I>(collections)->GetEntities(), entities, count * sizeof(Entity)) == 0) && ...);
+    }
+
+    template<typename Func, size_t... I>
+    void ForEachDense(Func& func, uint32_t begin, uint32_t end, std::index_sequence<I...>) const
+    {
+        const Entity* entities = std::get<0>(collections)->GetEntities();
+        const std::tuple<T*...> components(std::get<I>(collections)->GetComponents()...);
+
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            func(entities[i], std::get<I>(components)[i]...);
+        }
+    }
+
+    template<size_t... I>
+    void MarkChanged(std::index_sequence<I...>) const
+    {
+        const uint32_t count = std::get<0>(collections)->GetEntityCount();
+        (MarkChanged<I>(count), ...);
+    }
+
+    template<size_t I>
+    inline void MarkChanged(uint32_t count) const
+    {
+        if constexpr (!std::is_const_v<std::tuple_element_t<I, std::tuple<T...>>>)
+        {
+            std::get<I>(collections)->MarkIndexesChanged(0, count);
+        }
+    }
+
+    //run(count, forRange) calls forRange(begin, end) for the ranges that cover [0, count) of the smallest collection
+    //The ranges can run on multiple threads, so they do not write the versions of the collections. That is done after run returns
+    template<typename Func, typename Run, size_t... I>
+    void ForEachFromSmallest(Func& func, Run&& run, std::index_sequence<I...> indices) const
+    {
+        uint32_t smallestCount = ENTITYNULL;
+        size_t smallest = 0;
+
+        ((std::get<I>(collections)->GetEntityCount() < smallestCount ? (smallestCount = std::get<I>(collections)->GetEntityCount(), smallest = I) : 0), ...);
+        ((smallest == I ? run(smallestCount, [&](uint32_t begin, uint32_t end) { ForEachFrom<I>(func, begin, end, indices); }) : void()), ...);
+        ((smallest == I ? MarkVisitedChanged<I>(smallestCount, indices) : void()), ...);
+    }
+
+    template<size_t Driver, typename Func, size_t... I>
+    void ForEachFrom(Func& func, uint32_t begin, uint32_t end, std::index_sequence<I...>) const
+    {
+        const Entity* entities = std::get<Driver>(collections)->GetEntities();
+        const std::tuple<T*...> components(std::get<I>(collections)->GetComponents()...);
+
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const Entity entity = entities[i];
+
+            if (!((I == Driver || std::get<I>(collections)->HasComponent(entity)) && ...)) continue;
+
+            func(entity, std::get<I>(components)[I == Driver ? i : std::get<I>(collections)->GetIndex(entity)]...);
+        }
+    }
+
+    //Marks the non-const components of every entity the driving collection visited as changed
+    template<size_t Driver, size_t... I>
+    void MarkVisitedChanged(uint32_t count, std::index_sequence<I...>) const
+    {
+        if constexpr (!(std::is_const_v<T> && ...))
+        {
+            const Entity* entities = std::get<Driver>(collections)->GetEntities();
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const Entity entity = entities[i];
+
+                if (!((I == Driver || std::get<I>(collections)->HasComponent(entity)) && ...)) continue;
+
+                (MarkEntityChanged<I>(entity), ...);
+            }
+        }
+    }
+
+    template<size_t I>
+    inline void MarkEntityChanged(Entity entity) const
+    {
+        if constexpr (!std::is_const_v<std::tuple_element_t<I, std::tuple<T...>>>)
+        {
+            std::get<I>(collections)->MarkChanged(entity);
+        }
+    }
+
+private:
+    std::tuple<Collection<T>*...> collections;
+};
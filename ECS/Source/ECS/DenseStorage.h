@@ -0,0 +1,180 @@
+#pragma once
+
+#include "ECSSettings.h"
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+//Dense component storage of a ComponentCollection. Components are stored as an array of structs by default
+//A component can opt in to a struct of arrays layout by listing all of its data members: 'using Fields = FieldList<&T::A, &T::B>;'
+//Each field is then stored in its own aligned array, so a loop that only needs a few fields does not pull the other fields through the cache
+//The field list needs to contain all data members, members that are not listed are not stored
+
+template<auto... Member>
+struct FieldList { };
+
+template<typename T>
+concept HasFieldList = requires { typename T::Fields; };
+
+template<auto Member>
+struct MemberTraits;
+
+template<typename C, typename M, M C::* Member>
+struct MemberTraits<Member>
+{
+    using Class = C;
+    using Type = M;
+};
+
+//Stores the components in one array
+template<typename T, uint32_t Capacity>
+class StructArray
+{
+public:
+    using Reference = T&;
+    using ConstReference = const T&;
+
+    inline T& Get(uint32_t index) { return values[index]; }
+    inline const T& Get(uint32_t index) const { return values[index]; }
+
+    inline T* GetPointer(uint32_t index) { return &values[index]; }
+
+    inline void Set(uint32_t index, const T& value) { values[index] = value; }
+
+    inline void Move(uint32_t from, uint32_t to) { values[to] = values[from]; }
+
+    inline void Swap(uint32_t index1, uint32_t index2) { std::swap(values[index1], values[index2]); }
+
+    inline void Copy(const StructArray& other, uint32_t index) { values[index] = other.values[index]; }
+
+    inline void CopyRange(const StructArray& other, uint32_t count)
+    {
+        std::memcpy(values.data(), other.values.data(), count * sizeof(T));
+    }
+
+    inline T* Data() { return values.data(); }
+    inline const T* Data() const { return values.data(); }
+
+private:
+    std::array<T, Capacity> values;
+};
+
+//A single field of a component in a struct of arrays
+template<auto Member, uint32_t Capacity>
+struct alignas(64) FieldArray
+{
+    std::array<typename MemberTraits<Member>::Type, Capacity> Values;
+};
+
+template<typename T, uint32_t Capacity, typename Fields = typename T::Fields>
+class FieldArrays;
+
+//Stores every field of the components in its own array. Components are accessed through a Reference proxy,
+//which converts to and from T and gives access to single fields with Get<&T::Field>()
+template<typename T, uint32_t Capacity, auto... Member>
+class FieldArrays<T, Capacity, FieldList<Member...>> : private FieldArray<Member, Capacity>...
+{
+    static_assert(sizeof...(Member) > 0, "The field list needs at least one field");
+    static_assert((std::is_same_v<typename MemberTraits<Member>::Class, T> && ...), "The field list can only contain members of the component");
+
+public:
+    template<auto Field>
+    using FieldType = typename MemberTraits<Field>::Type;
+
+    class Reference
+    {
+    public:
+        Reference(FieldArrays* arrays, uint32_t index) : arrays(arrays), index(index) { }
+
+        template<auto Field>
+        inline FieldType<Field>& Get() const
+        {
+            return arrays->template GetField<Field>()[index];
+        }
+
+        inline operator T() const
+        {
+            T value;
+            ((value.*Member = Get<Member>()), ...);
+            return value;
+        }
+
+        inline const Reference& operator=(const T& value) const
+        {
+            ((Get<Member>() = value.*Member), ...);
+            return *this;
+        }
+
+    private:
+        FieldArrays* arrays;
+        uint32_t index;
+    };
+
+    using ConstReference = T;
+
+    inline Reference Get(uint32_t index) { return Reference(this, index); }
+
+    inline T Get(uint32_t index) const
+    {
+        T value;
+        ((value.*Member = GetField<Member>()[index]), ...);
+        return value;
+    }
+
+    inline Reference GetPointer(uint32_t index) { return Get(index); }
+
+    inline void Set(uint32_t index, const T& value)
+    {
+        ((GetField<Member>()[index] = value.*Member), ...);
+    }
+
+    inline void Move(uint32_t from, uint32_t to)
+    {
+        ((GetField<Member>()[to] = GetField<Member>()[from]), ...);
+    }
+
+    inline void Swap(uint32_t index1, uint32_t index2)
+    {
+        (std::swap(GetField<Member>()[index1], GetField<Member>()[index2]), ...);
+    }
+
+    inline void Copy(const FieldArrays& other, uint32_t index)
+    {
+        ((GetField<Member>()[index] = other.template GetField<Member>()[index]), ...);
+    }
+
+    inline void CopyRange(const FieldArrays& other, uint32_t count)
+    {
+        (std::memcpy(GetField<Member>(), other.template GetField<Member>(), count * sizeof(FieldType<Member>)), ...);
+    }
+
+    //Returns the array of a single field
+    template<auto Field>
+    inline FieldType<Field>* GetField()
+    {
+        return static_cast<FieldArray<Field, Capacity>&>(*this).Values.data();
+    }
+
+    template<auto Field>
+    inline const FieldType<Field>* GetField() const
+    {
+        return static_cast<const FieldArray<Field, Capacity>&>(*this).Values.data();
+    }
+};
+
+template<typename T, uint32_t Capacity>
+struct DenseStorageOf
+{
+    using Type = StructArray<T, Capacity>;
+};
+
+template<HasFieldList T, uint32_t Capacity>
+struct DenseStorageOf<T, Capacity>
+{
+    using Type = FieldArrays<T, Capacity>;
+};
+
+template<typename T, uint32_t Capacity>
+using DenseStorage = typename DenseStorageOf<T, Capacity>::Type;
@@ -1,14 +1,28 @@
 #pragma once
 
 #include "ECSSettings.h"
+#include "EntityHandle.h"
 #include "EntityPair.h"
+#include "OverwriteRecord.h"
 
+#include "SparseArray.h"
+#include "DenseStorage.h"
 #include "EntitySet.h"
-#include "EntityQueue.h"
+#include "EntityAllocator.h"
 
 #include "EntityManager.h"
 #include "ComponentCollection.h"
+#include "ComponentView.h"
+#include "OwningGroup.h"
 #include "ComponentManager.h"
+#include "ArchetypeManager.h"
 #include "SystemManager.h"
+#include "CommandBuffer.h"
+#include "ComponentObserver.h"
+#include "ResourceManager.h"
+#include "Prefab.h"
+#include "QueryManager.h"
+#include "ThreadPool.h"
+#include "SystemScheduler.h"
 
 #include "Layer.h"
\ No newline at end of file
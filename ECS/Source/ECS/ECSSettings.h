@@ -2,6 +2,7 @@
 
 #include <bitset>
 #include <cstdint>
+#include <limits>
 
 //Rollback
 static constexpr uint8_t MaxRollBackFrames = 15; //amount of save states
@@ -10,13 +11,33 @@ static constexpr uint8_t MaxRollBackFrames = 15; //amount of save states
 using Entity = uint32_t;
 using UInt_E = Entity;
 using EntityTwice = uint64_t;    //Should be double the size of Entity
+using EntityGeneration = uint32_t;
 using ComponentType = uint8_t;
 using SystemType = uint8_t;
 using WorldType = uint8_t;
 using FrameNumber = uint32_t;
 
-static constexpr uint32_t MAXENTITIES = 500;
-static constexpr Entity ENTITYNULL = MAXENTITIES + 1;
+static constexpr uint32_t MAXENTITIES = 500;    //Default entity capacity of a layer
+static constexpr Entity ENTITYNULL = std::numeric_limits<Entity>::max();
+
+//Sparse sets of layers with a larger capacity store their sparse array in pages
+static constexpr uint32_t SparsePageSize = 4096 / sizeof(uint32_t); //4 KB
+static constexpr uint32_t PagedSparseArrayThreshold = 4096;
+
+//Component storage of a layer
+enum class StorageMode : uint8_t
+{
+    SparseSet,  //One ComponentCollection per component type (default)
+    Archetype   //Entities with the same signature share fixed size chunks
+};
+
+//Parallel iteration splits the entities into chunks of a fixed size, so the chunks do not depend on the thread count
+static constexpr uint32_t ParallelChunkSize = 64;
+
+//Archetypes
+using ArchetypeType = uint16_t;
+static constexpr uint32_t ArchetypeChunkSize = 16 * 1024; //16 KB
+static constexpr ArchetypeType MaxArchetypes = 64;
 
 //Types
 static constexpr int32_t QUADTREE_MAX_DEPTH = 8;
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+
+#include "ECSSettings.h"
+
+//Hands out the lowest free entity ID, so the IDs of the active entities stay compact when entities are destroyed and created again
+//Every ID has a bit in the free bitset and every word of the bitset has a bit in the summary that is set while the word has a free ID,
+//so finding the lowest free ID is one find-first-set on the summary and one on the word
+template<uint32_t Capacity>
+class EntityAllocator
+{
+    static constexpr uint32_t WordCount = (Capacity + 63) / 64;
+    static constexpr uint32_t SummaryCount = (WordCount + 63) / 64;
+
+public:
+    EntityAllocator()
+    {
+        //All IDs are free, the bits behind the capacity stay cleared
+        for (uint32_t word = 0; word < WordCount; ++word)
+        {
+            freeIds[word] = GetMask(Capacity - word * 64);
+        }
+
+        for (uint32_t i = 0; i < SummaryCount; ++i)
+        {
+            summary[i] = GetMask(WordCount - i * 64);
+        }
+    }
+
+    //Copies the free IDs of the words that contain IDs below the used count. IDs at or above the used count need to be free in both allocators
+    //The cost scales with the used IDs and not with the capacity
+    void Overwrite(const EntityAllocator& other, uint32_t usedCount)
+    {
+        std::copy_n(other.freeIds.begin(), (usedCount + 63) / 64, freeIds.begin());
+        summary = other.summary;
+        freeCount = other.freeCount;
+    }
+
+    //Takes the lowest free ID
+    Entity Allocate()
+    {
+        assert(freeCount > 0 && "No free entity IDs left");
+
+        uint32_t i = 0;
+        while (summary[i] == 0) ++i;
+
+        const uint32_t word = i * 64 + std::countr_zero(summary[i]);
+        const Entity entity = word * 64 + std::countr_zero(freeIds[word]);
+
+        //Clear the lowest set bit and the summary bit once the word is full
+        freeIds[word] &= freeIds[word] - 1;
+
+        if (freeIds[word] == 0)
+        {
+            summary[i] &= ~(uint64_t(1) << (word % 64));
+        }
+
+        freeCount--;
+        return entity;
+    }
+
+    //Takes the given ID, which needs to be free
+    void Allocate(Entity entity)
+    {
+        assert(entity < Capacity && "Entity out of range");
+        assert(IsFree(entity) && "Entity ID is already taken");
+
+        const uint32_t word = entity / 64;
+        freeIds[word] &= ~(uint64_t(1) << (entity % 64));
+
+        if (freeIds[word] == 0)
+        {
+            summary[word / 64] &= ~(uint64_t(1) << (word % 64));
+        }
+
+        freeCount--;
+    }
+
+    //Returns the ID, so it can be handed out again
+    void Free(Entity entity)
+    {
+        assert(entity < Capacity && "Entity out of range");
+        assert(!IsFree(entity) && "Entity ID is already free");
+
+        freeIds[entity / 64] |= uint64_t(1) << (entity % 64);
+        summary[entity / 4096] |= uint64_t(1) << ((entity / 64) % 64);
+        freeCount++;
+    }
+
+    //Frees all IDs. IDs at or above the used count need to be free already
+    void Clear(uint32_t usedCount)
+    {
+        for (uint32_t word = 0; word < (usedCount + 63) / 64; ++word)
+        {
+            freeIds[word] = GetMask(Capacity - word * 64);
+        }
+
+        for (uint32_t i = 0; i < SummaryCount; ++i)
+        {
+            summary[i] = GetMask(WordCount - i * 64);
+        }
+
+        freeCount = Capacity;
+    }
+
+    inline bool IsFree(Entity entity) const
+    {
+        return (freeIds[entity / 64] >> (entity % 64)) & 1;
+    }
+
+    inline uint32_t GetFreeCount() const
+    {
+        return freeCount;
+    }
+
+private:
+    //Mask with the lowest count bits set
+    static constexpr uint64_t GetMask(uint32_t count)
+    {
+        return count >= 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+    }
+
+private:
+    std::array<uint64_t, WordCount> freeIds { };
+    std::array<uint64_t, SummaryCount> summary { };
+    uint32_t freeCount = Capacity;
+};
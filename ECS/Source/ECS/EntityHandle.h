@@ -0,0 +1,13 @@
+#pragma once
+
+#include "ECSSettings.h"
+
+//Identifies an entity together with the generation of its ID. The generation of an ID is increased every time the entity is destroyed,
+//so a handle of a destroyed entity stays invalid when the ID is reused by a new entity
+struct EntityHandle
+{
+    Entity Index;
+    EntityGeneration Generation;
+
+    inline constexpr bool operator==(const EntityHandle& other) const noexcept = default;
+};
@@ -1,87 +1,179 @@
 #pragma once
 
-#include "EntityQueue.h"
+#include "EntityAllocator.h"
+#include "EntityHandle.h"
+#include "OverwriteRecord.h"
 #include "ECSSettings.h"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
-#include <queue>
 #include <cstring>
+#include <span>
+#include <vector>
 
 //Manages the entities and allows for their creation and destruction
 //Saves the signature of each entity
-template<uint8_t ComponentCount>
+//The lowest free ID is handed out, so the IDs of the active entities stay compact. Only the entities below usedEntityCount have ever been used
+//The active entities are also kept in a dense list, so enumerating them scales with the active entities and not with the capacity
+//Every ID has a generation that is increased when the entity is destroyed, which makes handles of destroyed entities invalid
+//Signatures only change with structural changes, so overwriting from the same manager as last time is skipped when neither manager changed since then
+template<uint8_t ComponentCount, uint32_t Capacity = MAXENTITIES>
 class EntityManager
 {
 private:
 	using Signature = std::bitset<ComponentCount>;
 
 public:
-    //Initializes the EntityManager by populating a queue with all available entities
-	EntityManager()
+	EntityManager() : storageId(NextStorageId()) { }
+
+	//Only copies the signatures of the entities that have been used, the cost does not scale with the capacity
+	void Overwrite(const EntityManager& other)
 	{
-		for (Entity entity = 0; entity < MAXENTITIES; ++entity)
+		if (!record.IsUnchanged(other.storageId, other.changedVersion, changedVersion))
 		{
-			availableEntities.Push(entity);
+			OverwriteAll(other);
 		}
-	}
 
-	void Overwrite(const EntityManager& other)
-	{
-		std::memcpy(this, &other, sizeof(EntityManager));
+		record = { other.storageId, other.version++, version++ };
 	}
 
     //Creates a new entity and returns the entity ID
 	Entity CreateEntity()
 	{
-		assert(activeEntityCount < MAXENTITIES && "Too many entities. Extend the buffer size");
+		assert(activeEntityCount < Capacity && "Too many entities. Extend the capacity of the layer");
+
+		const Entity id = freeEntities.Allocate();
+		usedEntityCount = std::max(usedEntityCount, id + 1);
 
-		Entity id = availableEntities.Front();
-		availableEntities.Pop();
-		activeEntityCount++;
+		activeIndexes[id] = activeEntityCount;
+		activeEntities[activeEntityCount++] = id;
+		changedVersion = version;
 
 		return id;
 	}
 
+    //Creates the entity with the given ID, which needs to be free
+	void CreateEntity(Entity entity)
+	{
+		assert(activeEntityCount < Capacity && "Too many entities. Extend the capacity of the layer");
+
+		freeEntities.Allocate(entity);
+		usedEntityCount = std::max(usedEntityCount, entity + 1);
+
+		activeIndexes[entity] = activeEntityCount;
+		activeEntities[activeEntityCount++] = entity;
+		changedVersion = version;
+	}
+
+    //Creates count new entities with the lowest free IDs and writes them into entities
+	void CreateEntities(uint32_t count, std::vector<Entity>& entities)
+	{
+		assert(activeEntityCount + count <= Capacity && "Too many entities. Extend the capacity of the layer");
+
+		entities.clear();
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const Entity id = freeEntities.Allocate();
+			usedEntityCount = std::max(usedEntityCount, id + 1);
+
+			activeIndexes[id] = activeEntityCount;
+			activeEntities[activeEntityCount++] = id;
+			entities.push_back(id);
+		}
+
+		changedVersion = version;
+	}
+
     //Destroys the entity and frees up the space for one additional entity
 	void DestroyEntity(Entity entity)
 	{
-		assert(entity < MAXENTITIES && "Entity out of range");
+		assert(entity < Capacity && "Entity out of range");
+		assert(activeIndexes[entity] < activeEntityCount && activeEntities[activeIndexes[entity]] == entity && "Destroying an entity that is not active");
+
+		//Move the last active entity into the gap
+		const Entity lastEntity = activeEntities[--activeEntityCount];
+		activeEntities[activeIndexes[entity]] = lastEntity;
+		activeIndexes[lastEntity] = activeIndexes[entity];
 
 		signatures[entity].reset();
-		availableEntities.Push(entity);
-		activeEntityCount--;
+		generations[entity]++;
+		freeEntities.Free(entity);
+		changedVersion = version;
 	}
 
     //Assigns a signature to the entity
 	void SetSignature(Entity entity, Signature signature)
 	{
-		assert(entity < MAXENTITIES && "Entity out of range");
+		assert(entity < Capacity && "Entity out of range");
 
 		signatures[entity] = signature;
+		changedVersion = version;
 	}
 
     //Gets the signature of the given entity
 	Signature GetSignature(Entity entity) const
 	{
-		assert(entity < MAXENTITIES && "Entity out of range");
+		assert(entity < Capacity && "Entity out of range");
 
 		return signatures[entity];
 	}
 
+	//Destroys all entities and frees all IDs. The cost scales with the used entities and not with the capacity
+	//The generations are kept, so the generation of an ID never goes back to an older value
+	void Clear()
+	{
+		std::fill_n(signatures.begin(), usedEntityCount, Signature());
+		freeEntities.Clear(usedEntityCount);
+
+		activeEntityCount = 0;
+		usedEntityCount = 0;
+		changedVersion = version;
+	}
+
+	//Gets a handle of the entity that stays comparable after the entity is destroyed and its ID is reused
+	EntityHandle GetHandle(Entity entity) const
+	{
+		assert(entity < Capacity && "Entity out of range");
+
+		return EntityHandle { entity, generations[entity] };
+	}
+
+	//Checks whether the entity of the handle has not been destroyed since the handle was made
+	bool IsValid(EntityHandle handle) const
+	{
+		return handle.Index < Capacity && generations[handle.Index] == handle.Generation && activeIndexes[handle.Index] < activeEntityCount && activeEntities[activeIndexes[handle.Index]] == handle.Index;
+	}
+
+	//Gets the generation of every entity ID that has been used, indexed by the entity. The span only covers the IDs that are used at the time of the call
+	std::span<const EntityGeneration> GetGenerations() const
+	{
+		return { generations.data(), usedEntityCount };
+	}
+
 	//Returns the count of all current active entities
 	uint32_t GetEntityCount() const
 	{
 		return activeEntityCount;
 	}
 
+	//Gets the active entities in the order of the dense list
+	std::span<const Entity> GetActiveEntities() const
+	{
+		return std::span<const Entity>(activeEntities.data(), activeEntityCount);
+	}
+
 	//Gives a vector with all active entities that have at least one component that is included and its signature (excluding components that are not included)
+	//The vectors are cleared first, so they can be reused without allocating again
 	void GetActiveEntities(Signature includedComponents, std::vector<Entity>& entities, std::vector<Signature>& outSignatures) const
 	{
+		entities.clear();
+		outSignatures.clear();
 		outSignatures.reserve(activeEntityCount);
 		entities.reserve(activeEntityCount);
 
-		for (Entity entity = 0; entity < MAXENTITIES; ++entity)
+		for (const Entity entity : GetActiveEntities())
 		{
 			Signature signature = signatures[entity];
 
@@ -93,8 +185,51 @@ public:
 		}
 	}
 
+	//Calls func(entity) for every active entity whose signature contains all the required components
+	template<typename Func>
+	void ForEachEntity(Signature required, Func&& func) const
+	{
+		for (const Entity entity : GetActiveEntities())
+		{
+			if ((signatures[entity] & required) == required)
+			{
+				func(entity);
+			}
+		}
+	}
+
+private:
+	void OverwriteAll(const EntityManager& other)
+	{
+		std::copy_n(other.signatures.begin(), other.usedEntityCount, signatures.begin());
+
+		if (usedEntityCount > other.usedEntityCount)
+		{
+			std::fill(signatures.begin() + other.usedEntityCount, signatures.begin() + usedEntityCount, Signature());
+		}
+
+		std::copy_n(other.activeEntities.begin(), other.activeEntityCount, activeEntities.begin());
+		std::copy_n(other.activeIndexes.begin(), other.usedEntityCount, activeIndexes.begin());
+		std::copy_n(other.generations.begin(), std::max(usedEntityCount, other.usedEntityCount), generations.begin());
+
+		freeEntities.Overwrite(other.freeEntities, std::max(usedEntityCount, other.usedEntityCount));
+
+		activeEntityCount = other.activeEntityCount;
+		usedEntityCount = other.usedEntityCount;
+		changedVersion = version;
+	}
+
 private:
 	uint32_t activeEntityCount { };
-	std::array<Signature, MAXENTITIES> signatures { };
-	EntityQueue<MAXENTITIES> availableEntities { };
+	uint32_t usedEntityCount { };
+	std::array<Signature, Capacity> signatures { };
+	std::array<Entity, Capacity> activeEntities { };		//Dense list of the active entities
+	std::array<uint32_t, Capacity> activeIndexes { };		//Index of each used entity in the dense list
+	std::array<EntityGeneration, Capacity> generations { };
+	EntityAllocator<Capacity> freeEntities { };
+
+	uint64_t storageId;
+	mutable uint32_t version { 1 };	//Also advanced by the managers that overwrite themselves with this manager
+	uint32_t changedVersion { 1 };
+	OverwriteRecord record { };
 };
\ No newline at end of file
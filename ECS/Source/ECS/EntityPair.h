@@ -1,23 +1,32 @@
 #pragma once
 
 #include "ECSSettings.h"
+#include "EntityHandle.h"
 
+//Key of two entities. Pairs made from handles also contain the generations, so a pair of a destroyed entity never matches a pair of a new entity with the same ID
+//The pairs are ordered by the entity IDs first, so the generations do not change the order of pairs with different IDs
 struct EntityPair
 {
     EntityTwice Key;
+    EntityTwice Generations;
 
     static constexpr EntityPair Make(Entity entity1, Entity entity2) noexcept
     {
-        return EntityPair{ (static_cast<EntityTwice>(entity1) << 32) | entity2 };
+        return EntityPair{ (static_cast<EntityTwice>(entity1) << 32) | entity2, 0 };
+    }
+
+    static constexpr EntityPair Make(EntityHandle entity1, EntityHandle entity2) noexcept
+    {
+        return EntityPair{ (static_cast<EntityTwice>(entity1.Index) << 32) | entity2.Index, (static_cast<EntityTwice>(entity1.Generation) << 32) | entity2.Generation };
     }
 
     inline constexpr bool operator<(const EntityPair& other) const noexcept
     {
-        return Key < other.Key;
+        return Key < other.Key || (Key == other.Key && Generations < other.Generations);
     }
 
     inline constexpr bool operator==(const EntityPair& other) const noexcept
     {
-        return Key == other.Key;
+        return Key == other.Key && Generations == other.Generations;
     }
 };
\ No newline at end of file
@@ -1,12 +1,17 @@
 #pragma once
 
 #include "ECSSettings.h"
+#include "SparseArray.h"
+#include "OverwriteRecord.h"
+#include "ThreadPool.h"
 
 #include <cstdint>
 #include <cassert>
 #include <array>
 #include <cstring>
 
+//Dense set of entities, all entity IDs need to be smaller than the capacity
+//The set remembers the version of its last change, so overwriting it from the same set as last time is skipped when neither set changed
 template<uint32_t Capacity>
 class EntitySet
 {
@@ -15,33 +20,56 @@ public:
 
     inline void Initialize()
     {
-        entityToIndex.fill(InvalidEntity);
+        entityToIndex.Initialize();
         entityCount = 0;
+        version = 1;
+        changedVersion = version;
+        storageId = NextStorageId();
+        record.Reset();
     }
 
     EntitySet& operator=(const EntitySet& other)
     {
         if (this == &other) return *this;
 
-        entityCount = other.entityCount;
+        //Only the entries of the entities in both sets are touched, so the cost does not scale with the capacity
+        Clear();
 
+        entityCount = other.entityCount;
         std::memcpy(entities.data(), other.entities.data(), entityCount * sizeof(Entity));
-        std::memcpy(entityToIndex.data(), other.entityToIndex.data(), entityToIndex.size() * sizeof(uint32_t));
 
+        for (uint32_t i = 0; i < entityCount; ++i)
+        {
+            entityToIndex.Set(entities[i], i);
+        }
+
+        changedVersion = version;
         return *this;
     }
 
+    //Copies the other set, unless it is the source of the last overwrite and neither set changed since then
+    void Overwrite(const EntitySet& other)
+    {
+        if (!record.IsUnchanged(other.storageId, other.changedVersion, changedVersion))
+        {
+            *this = other;
+        }
+
+        record = { other.storageId, other.version++, version++ };
+    }
+
     bool Insert(Entity entity)
     {
-        assert(entity < MAXENTITIES && "Entity out of range");
+        assert(entity < Capacity && "Entity out of range");
 
-        if (entityToIndex[entity] != InvalidEntity) return false;
+        if (entityToIndex.Get(entity) != InvalidEntity) return false;
 
         assert(entityCount < Capacity && "EntitySet capacity exceeded");
 
         uint32_t index = entityCount++;
         entities[index] = entity;
-        entityToIndex[entity] = index;
+        entityToIndex.Set(entity, index);
+        changedVersion = version;
 
         return true;
     }
@@ -49,9 +77,9 @@ public:
     //Removes the entity from the given entity
     void Erase(Entity entity)
     {
-        assert(entity < MAXENTITIES && "Entity out of range");
+        assert(entity < Capacity && "Entity out of range");
 
-        uint32_t index = entityToIndex[entity];
+        uint32_t index = entityToIndex.Get(entity);
 
         if (index == InvalidEntity) return;
 
@@ -60,27 +88,43 @@ public:
 
         //Swap the last entity into the removed spot
         entities[index] = lastEntity;
-        entityToIndex[lastEntity] = index;
+        entityToIndex.Set(lastEntity, index);
 
         //Invalidate the removed entity
-        entityToIndex[entity] = InvalidEntity;
+        entityToIndex.Reset(entity);
         entityCount--;
+        changedVersion = version;
     }
 
     inline bool Contains(Entity entity) const
     {
-        assert(entity < MAXENTITIES && "Entity out of range");
-        return entityToIndex[entity] != InvalidEntity;
+        assert(entity < Capacity && "Entity out of range");
+        return entityToIndex.Get(entity) != InvalidEntity;
     }
 
     void Clear()
     {
         for (uint32_t i = 0; i < entityCount; ++i)
         {
-            entityToIndex[entities[i]] = InvalidEntity;
+            entityToIndex.Reset(entities[i]);
         }
 
         entityCount = 0;
+        changedVersion = version;
+    }
+
+    //Calls func(entity) for every entity, split over the thread pool in chunks of ParallelChunkSize
+    //The entities are not allowed to be inserted or erased during the iteration and func should only write data of its own entity
+    template<typename Func>
+    void ForEachParallel(ThreadPool& threadPool, Func&& func) const
+    {
+        threadPool.ParallelFor(entityCount, ParallelChunkSize, [this, &func](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                func(entities[i]);
+            }
+        });
     }
 
     uint32_t Size() const { return entityCount; }
@@ -94,12 +138,17 @@ public:
     const Entity* end() const { return entities.data() + entityCount; }
 
 private:
-    static constexpr uint32_t InvalidEntity = Capacity;
+    static constexpr uint32_t InvalidEntity = ENTITYNULL;
 
     std::array<Entity, Capacity> entities;
-    std::array<uint32_t, MAXENTITIES> entityToIndex;
+    SparseArray<Capacity> entityToIndex;
 
     uint32_t entityCount;
+
+    mutable uint32_t version;   //Also advanced by the sets that overwrite themselves with this set
+    uint32_t changedVersion;
+    uint64_t storageId;
+    OverwriteRecord record;
 };
 
 static_assert(std::is_trivially_default_constructible_v<EntitySet<10>>, "EntitySet needs to be trivial");
\ No newline at end of file
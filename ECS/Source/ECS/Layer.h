@@ -3,31 +3,47 @@
 #include "ECSSettings.h"
 #include "EntityManager.h"
 #include "ComponentManager.h"
+#include "ArchetypeManager.h"
 #include "SystemManager.h"
-
+#include "CommandBuffer.h"
+#include "ComponentObserver.h"
+#include "ResourceManager.h"
+#include "Prefab.h"
+#include "QueryManager.h"
+
+#include <span>
+#include <type_traits>
 #include <vector>
 
 //Manages the different managers (EntityManager, ComponentManager and SystemManager)
 //Has functionality for modifying the components, systems and signatures of entities
 
+//The components are stored in a ComponentManager (sparse sets) or in an ArchetypeManager (chunks per signature), depending on the storage mode
+
 //Manages all component collections and uses the component name for easy lookups
-template<typename ComponentList, typename SystemList>
+//The capacity limits the amount of entities of the layer. All managers are sized by it, but overwriting a layer only scales with the entities that are used
+//Resources hold the state of the layer that does not belong to an entity, which is overwritten together with the entities
+template<typename ComponentList, typename SystemList, uint32_t Capacity = MAXENTITIES, StorageMode Storage = StorageMode::SparseSet, typename ResourceList = TypeList<>>
 class Layer;
 
-template<typename... Component, typename... System>
-class Layer<ComponentList<Component...>, SystemList<System...>>
+template<typename... Component, typename... System, uint32_t Capacity, StorageMode Storage, typename... Resource>
+class Layer<ComponentList<Component...>, SystemList<System...>, Capacity, Storage, ResourceList<Resource...>>
 {
     using Components = ComponentList<Component...>;
     using Systems = SystemList<System...>;
+    using Resources = ResourceList<Resource...>;
     using Signature = std::bitset<Count_v<Components>>;
+    using ComponentStorage = std::conditional_t<Storage == StorageMode::Archetype, ArchetypeManager<Components, Capacity>, ComponentManager<Components, Capacity>>;
 
 public:
+    static constexpr uint32_t EntityCapacity = Capacity;
+
     Layer() :
-        entityManager(EntityManager<ComponentCount>()),
-        componentManager(ComponentManager<Components>()),
-        systemManager(SystemManager<Components, Systems>(componentManager)),
-        ignoreSignatureChanged(false) { }
+        entityManager(),
+        componentManager(),
+        systemManager(componentManager) { }
 
+    //Copies the other layer. Overwriting repeatedly between the same two layers only copies what changed in one of them since the last overwrite
     void Overwrite(const Layer& other)
     {
         assert(entitiesToDestroy.size() == 0 && "DestroyMarkedEntities() needs to be called first before overwriting the layer");
@@ -35,6 +51,24 @@ public:
         entityManager.Overwrite(other.entityManager);
         componentManager.Overwrite(other.componentManager);
         systemManager.Overwrite(other.systemManager);
+        resourceManager.Overwrite(other.resourceManager);
+
+        observers.Reset();
+        queries.Invalidate();
+    }
+
+    //Destroys all entities and resets the layer to an empty layer in place, so scratch layers can be reused without allocating a new layer
+    //Only the entries of the used entities and components are reset, instead of initializing the whole layer again. The resources are kept
+    void Clear()
+    {
+        entitiesToDestroy.clear();
+
+        systemManager.Clear();
+        componentManager.Clear();
+        entityManager.Clear();
+
+        observers.Reset();
+        queries.Invalidate();
     }
 
     //Entity methods
@@ -45,6 +79,34 @@ public:
         return entityManager.CreateEntity();
     }
 
+    //Creates count new entities and writes them into entities
+    void CreateEntities(uint32_t count, std::vector<Entity>& entities)
+    {
+        entityManager.CreateEntities(count, entities);
+    }
+
+    //Creates the entity with the given ID, which needs to be free. Used to rebuild a layer with the same entity IDs
+    void CreateEntity(Entity entity)
+    {
+        entityManager.CreateEntity(entity);
+    }
+
+    //Creates an entity with the components of the prefab. Only available for the sparse set storage
+    Entity Instantiate(const Prefab<Components>& prefab) requires (Storage == StorageMode::SparseSet)
+    {
+        const Entity entity = entityManager.CreateEntity();
+        InstantiatePrefab(prefab, std::span<const Entity>(&entity, 1));
+        return entity;
+    }
+
+    //Creates count entities with the components of the prefab and writes them into entities
+    //Every component collection gets one append and every entity enters its systems once. Only available for the sparse set storage
+    void Instantiate(const Prefab<Components>& prefab, uint32_t count, std::vector<Entity>& entities) requires (Storage == StorageMode::SparseSet)
+    {
+        entityManager.CreateEntities(count, entities);
+        InstantiatePrefab(prefab, entities);
+    }
+
     //Marks the entity for destruction, destroy the marked entities later, when the component references have been dropped with DestroyMarkedEntities()
     void MarkEntityForDestruction(Entity entity)
     {
@@ -54,22 +116,49 @@ public:
     //Destroys the entities that are marked and removes any components and systems that are related to the entities
     void DestroyMarkedEntities()
     {
-        for (const Entity entity : entitiesToDestroy)
+        DestroyEntities(entitiesToDestroy);
+        entitiesToDestroy.clear();
+    }
+
+    //Unsafe method to instantly destroy the entities with their components and systems. Each entity can only be given once
+    //Every system and every component collection is visited once for all entities, instead of once per entity
+    void DestroyEntities(std::span<const Entity> entities)
+    {
+        for (const Entity entity : entities)
         {
+            NotifySignatureChanged(entity, entityManager.GetSignature(entity), Signature());
             entityManager.DestroyEntity(entity);
-            componentManager.DestroyEntity(entity);
-            systemManager.DestroyEntity(entity);
         }
 
-        entitiesToDestroy.clear();
+        systemManager.DestroyEntities(entities);
+        componentManager.DestroyEntities(entities);
     }
 
     //Unsafe method to instantly remove an entities with it components and systems
     void ImmediatelyDestroyEntity(Entity entity)
     {
+        NotifySignatureChanged(entity, entityManager.GetSignature(entity), Signature());
         entityManager.DestroyEntity(entity);
-        componentManager.DestroyEntity(entity);
         systemManager.DestroyEntity(entity);
+        componentManager.DestroyEntity(entity);
+    }
+
+    //Gets a handle of the entity that becomes invalid when the entity is destroyed, also when its ID is reused later
+    EntityHandle GetHandle(Entity entity) const
+    {
+        return entityManager.GetHandle(entity);
+    }
+
+    //Checks whether the entity of the handle still exists
+    bool IsValid(EntityHandle handle) const
+    {
+        return entityManager.IsValid(handle);
+    }
+
+    //Gets the generation of every entity ID that has been used, indexed by the entity. The span only covers the IDs that are used at the time of the call
+    std::span<const EntityGeneration> GetGenerations() const
+    {
+        return entityManager.GetGenerations();
     }
 
     //Returns the count of all current active entities
@@ -84,75 +173,264 @@ public:
         return entityManager.GetSignature(entity);
     }
 
+    //Gets all active entities in the order of the dense entity list
+    std::span<const Entity> GetActiveEntities() const
+    {
+        return entityManager.GetActiveEntities();
+    }
+
     //Gives a vector with all active entities that have at least one component that is included and its signature (excluding components that are not included)
     void GetActiveEntities(Signature includedComponents, std::vector<Entity>& entities, std::vector<Signature>& signatures) const
     {
         return entityManager.GetActiveEntities(includedComponents, entities, signatures);
     }
 
+    //Applies the recorded commands of the buffer in one batch. Can not be called while systems are iterating over their entities
+    //The entities leave the systems of the removed components first, while the components still exist. Then the components are removed and added
+    //per collection, after which the entities enter the systems of the added components. Marked entities are destroyed last
+    void Apply(CommandBuffer<Components, Capacity>& commands)
+    {
+        for (uint32_t i = static_cast<uint32_t>(commands.createdEntities.size()); i < commands.createdCount; ++i)
+        {
+            commands.createdEntities.push_back(entityManager.CreateEntity());
+        }
+
+        commands.ResolveEntities();
+        commands.CollectChanges();
+
+        for (const auto& change : commands.changes)
+        {
+            if (change.Removed.none()) continue;
+
+            Signature oldSignature = entityManager.GetSignature(change.Target);
+            Signature signature = oldSignature & ~change.Removed;
+            assert((oldSignature & change.Removed) == change.Removed && "Removing a component that does not exist");
+
+            entityManager.SetSignature(change.Target, signature);
+            systemManager.EntitySignatureChanged(change.Target, oldSignature, signature);
+            NotifySignatureChanged(change.Target, oldSignature, signature);
+        }
+
+        (ApplyComponentCommands<Component>(commands), ...);
+
+        for (const auto& change : commands.changes)
+        {
+            if (change.Added.none()) continue;
+
+            Signature oldSignature = entityManager.GetSignature(change.Target);
+            Signature signature = oldSignature | change.Added;
+
+            entityManager.SetSignature(change.Target, signature);
+            systemManager.EntitySignatureChanged(change.Target, oldSignature, signature);
+            NotifySignatureChanged(change.Target, oldSignature, signature);
+        }
+
+        DestroyEntities(commands.destructions);
+
+        commands.FinishApply();
+    }
+
     //Component methods
 
     //Adds the component to the given entity, updates the signature and updates on which systems the entity is registered based on the signature
+    //The component is added before the systems are notified, so owning groups can move it
+    //Returns a pointer to the component, or a reference proxy for components with a field list
+    //Tags only update the signature and the systems and return nothing
     template<typename T>
-    T* AddComponent(Entity entity, T component)
+    auto AddComponent(Entity entity, T component)
     {
+        if constexpr (!TagComponent<T>)
+        {
+            componentManager.template AddComponent<T>(entity, component);
+        }
+
         //Render the signature of the entity by including the new component
-        Signature signature = entityManager.GetSignature(entity);
+        Signature oldSignature = entityManager.GetSignature(entity);
+        Signature signature = oldSignature;
         signature.set(GetComponentType<T>(), true);
         entityManager.SetSignature(entity, signature);
 
-        //Notify the system manager about the new signature
-        if (!ignoreSignatureChanged)
+        //Notify the systems that require the component about the new signature
+        systemManager.template ComponentAdded<T>(entity, signature);
+        NotifySignatureChanged(entity, oldSignature, signature);
+
+        if constexpr (TagComponent<T>)
         {
-            systemManager.EntitySignatureChanged(entity, signature);
+            return;
+        }
+        else if constexpr (std::is_reference_v<decltype(componentManager.template GetComponent<T>(entity))>)
+        {
+            return &componentManager.template GetComponent<T>(entity);
+        }
+        else
+        {
+            return componentManager.template GetComponent<T>(entity);
         }
-
-        return componentManager.template AddComponent<T>(entity, component);
     }
 
     //Removes the component of type T from the entity, updates the signature and updates on which systems the entity is registered based on the signature
+    //The systems are notified before the component is removed, so owning groups can move the entity out of the group first
     template<typename T>
     void RemoveComponent(Entity entity)
     {
-        componentManager.template RemoveComponent<T>(entity);
-
         //Render the signature of the entity by removing the component
-        Signature signature = entityManager.GetSignature(entity);
-        signature.set(componentManager.template GetComponentType<T>(), false);
+        Signature oldSignature = entityManager.GetSignature(entity);
+        Signature signature = oldSignature;
+        signature.set(GetComponentType<T>(), false);
         entityManager.SetSignature(entity, signature);
 
-        //Notify the system manager about the new signature
-        if (!ignoreSignatureChanged)
+        //Notify the systems that require the component about the new signature
+        systemManager.template ComponentRemoved<T>(entity, oldSignature);
+        NotifySignatureChanged(entity, oldSignature, signature);
+
+        if constexpr (!TagComponent<T>)
         {
-            systemManager.EntitySignatureChanged(entity, signature);
+            componentManager.template RemoveComponent<T>(entity);
         }
     }
 
-    //Gets a reference to the component of type T for the given entity
+    //Gets a reference to the component of type T for the given entity, or a reference proxy for components with a field list
     template<typename T>
-    inline T& GetComponent(Entity entity)
+    inline decltype(auto) GetComponent(Entity entity)
     {
         return componentManager.template GetComponent<T>(entity);
     }
 
+    //Only available for the sparse set storage
     template<typename T>
-    inline constexpr ComponentCollection<T>* GetComponentCollection()
+    inline constexpr ComponentCollection<T, Capacity>* GetComponentCollection() requires (Storage == StorageMode::SparseSet)
     {
         return componentManager.template GetComponentCollection<T>();
     }
 
-    //Checks whether the given entity has the component of type T
+    //Creates a view that iterates over all entities with all the given components, driven by the smallest collection. Only available for the sparse set storage
+    template<typename... T>
+    inline ComponentView<Capacity, T...> View() requires (Storage == StorageMode::SparseSet)
+    {
+        return componentManager.template View<T...>();
+    }
+
+    //Checks whether the given entity has the component of type T. Tags are tested on the signature of the entity
     template<typename T>
     inline bool HasComponent(Entity entity) const
     {
-        return componentManager.template HasComponent<T>(entity);
+        if constexpr (TagComponent<T>)
+        {
+            return entityManager.GetSignature(entity).test(GetComponentType<T>());
+        }
+        else
+        {
+            return componentManager.template HasComponent<T>(entity);
+        }
+    }
+
+    //Calls func(entity) for every entity whose signature contains all the given components or tags
+    template<typename... T, typename Func>
+    void ForEachEntity(Func&& func) const
+    {
+        Signature required;
+        (required.set(GetComponentType<T>()), ...);
+
+        entityManager.ForEachEntity(required, std::forward<Func>(func));
     }
 
     //Get the unique ComponentType ID for a component type T
     template<typename T>
     static constexpr ComponentType GetComponentType()
     {
-       return ComponentManager<Components>::template GetComponentType<T>();
+       return ComponentStorage::template GetComponentType<T>();
+    }
+
+    //Calls func(entity, components&...) for every entity that has all the given components. Only available for the archetype storage
+    template<typename... T, typename Func>
+    void ForEach(Func&& func) requires (Storage == StorageMode::Archetype)
+    {
+        componentManager.template ForEach<T...>(std::forward<Func>(func));
+    }
+
+    //Calls func(count, entities, componentArrays...) for every archetype chunk that has all the given components. Only available for the archetype storage
+    template<typename... T, typename Func>
+    void ForEachChunk(Func&& func) requires (Storage == StorageMode::Archetype)
+    {
+        componentManager.template ForEachChunk<T...>(std::forward<Func>(func));
+    }
+
+    //Observer methods
+
+    //Starts collecting the entities that get or lose component T. The observer starts as reset, so the observed state is built from the layer first
+    //The lists keep growing until they are cleared with ClearObservers(), usually after they have been processed at the end of a frame
+    template<typename T>
+    const ComponentObserver<Capacity>& Observe()
+    {
+        return observers.Observe(GetComponentType<T>());
+    }
+
+    template<typename T>
+    const ComponentObserver<Capacity>& GetObserver() const
+    {
+        return observers.GetObserver(GetComponentType<T>());
+    }
+
+    //Drops the collected changes of all observers
+    void ClearObservers()
+    {
+        observers.Clear();
+    }
+
+    //Query methods
+
+    //Creates a query for the entities that have all required and none of the excluded components
+    //The matching entities are kept up to date with every structural change, so reading them does not scan the entities
+    QueryId CreateQuery(Signature required, Signature excluded = Signature())
+    {
+        return queries.Create(required, excluded, entityManager);
+    }
+
+    //Creates a query from component lists: CreateQuery<ComponentList<Transform, RigidBodyData>, ComponentList<StaticBody>>()
+    template<typename Required, typename Excluded = ComponentList<>>
+    QueryId CreateQuery()
+    {
+        return CreateQuery(MakeSignature(Required()), MakeSignature(Excluded()));
+    }
+
+    void DestroyQuery(QueryId query)
+    {
+        queries.Destroy(query);
+    }
+
+    //Gets the entities that currently match the query. Structural changes are not allowed while iterating over them
+    const EntitySet<Capacity>& GetQuery(QueryId query)
+    {
+        return queries.Get(query, entityManager);
+    }
+
+    //Resource methods
+
+    //Gets the resource of type T and marks it as changed, so the next overwrite copies it
+    template<typename T>
+    T& GetResource()
+    {
+        return resourceManager.template GetResource<T>();
+    }
+
+    //Gets the resource of type T without marking it as changed
+    template<typename T>
+    const T& GetResource() const
+    {
+        return resourceManager.template GetResource<T>();
+    }
+
+    template<typename T>
+    void SetResource(const T& resource)
+    {
+        resourceManager.SetResource(resource);
+    }
+
+    //Marks the resource as changed, needed when it is written through a reference or pointer that was taken earlier
+    template<typename T>
+    void MarkResourceChanged()
+    {
+        resourceManager.template MarkChanged<T>();
     }
 
     //Systems methods
@@ -172,32 +450,79 @@ public:
     template<typename T>
     static constexpr Signature GetSystemSignature()
     {
-        return SystemManager<Components, Systems>::template GetSystemSignature<T>();
+        return SystemManager<Components, Systems, Capacity>::template GetSystemSignature<T>();
     }
 
-    //When batch-adding new systems (with ignoreSignatureChanged = true) call this function after to add all systems based on the current signature
-    void FinalizeEntitySystems(Entity entity)
+private:
+    static constexpr size_t ComponentCount = Count_v<Components>;
+
+    //Updates the observers and queries after the signature of the entity changed
+    inline void NotifySignatureChanged(Entity entity, Signature oldSignature, Signature newSignature)
     {
-        systemManager.EntitySignatureChanged(entity, entityManager.GetSignature(entity));
-        ignoreSignatureChanged = false;
+        observers.SignatureChanged(entity, oldSignature, newSignature);
+        queries.SignatureChanged(entity, oldSignature, newSignature);
     }
 
-    void IgnoreSignatureChanged(bool value)
+    template<typename... T>
+    static constexpr Signature MakeSignature(ComponentList<T...>)
     {
-        ignoreSignatureChanged = value;
+        Signature signature;
+        (signature.set(GetComponentType<T>()), ...);
+        return signature;
     }
 
-private:
-    static constexpr size_t ComponentCount = Count_v<Components>;
+    //The components are added before the systems are notified, so owning groups can move them
+    void InstantiatePrefab(const Prefab<Components>& prefab, std::span<const Entity> entities)
+    {
+        const Signature signature = prefab.GetSignature();
 
-    EntityManager<ComponentCount> entityManager;
-    ComponentManager<Components> componentManager;
-    SystemManager<Components, Systems> systemManager;
+        (InstantiateComponent<Component>(prefab, entities), ...);
 
-    std::vector<Entity> entitiesToDestroy { };
-    bool ignoreSignatureChanged;
-};
+        for (const Entity entity : entities)
+        {
+            entityManager.SetSignature(entity, signature);
+            NotifySignatureChanged(entity, Signature(), signature);
+        }
+
+        systemManager.EntitiesSignatureChanged(entities, Signature(), signature);
+    }
 
-//TODO: Ideas to improve:
-// - don't always erase or insert into the system entity set in EntitySignatureChanged()
-// - Archetype ECS
\ No newline at end of file
+    template<typename T>
+    inline void InstantiateComponent(const Prefab<Components>& prefab, std::span<const Entity> entities)
+    {
+        if constexpr (!TagComponent<T>)
+        {
+            if (prefab.template Has<T>())
+            {
+                componentManager.AddComponents(entities, prefab.template Get<T>());
+            }
+        }
+    }
+
+    //Tags have no storage, their signature bits are set with the changes
+    template<typename T>
+    void ApplyComponentCommands(const CommandBuffer<Components, Capacity>& commands)
+    {
+        if constexpr (!TagComponent<T>)
+        {
+            for (const Entity entity : commands.removals[GetComponentType<T>()])
+            {
+                componentManager.template RemoveComponent<T>(entity);
+            }
+
+            for (const std::pair<Entity, T>& addition : std::get<std::vector<std::pair<Entity, T>>>(commands.additions))
+            {
+                componentManager.template AddComponent<T>(addition.first, addition.second);
+            }
+        }
+    }
+
+    EntityManager<ComponentCount, Capacity> entityManager;
+    ComponentStorage componentManager;
+    SystemManager<Components, Systems, Capacity> systemManager;
+    ResourceManager<Resources> resourceManager;
+    ObserverManager<Components, Capacity> observers;
+    QueryManager<ComponentCount, Capacity> queries;
+
+    std::vector<Entity> entitiesToDestroy { };
+};
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+//Gives every storage (collection, set or manager) an ID when it is initialized. IDs are never reused,
+//so a new storage at the address of a destroyed storage does not match the record of an earlier overwrite
+inline uint64_t NextStorageId()
+{
+    static std::atomic<uint64_t> nextId = 1;
+    return nextId++;
+}
+
+//Remembers the last overwrite of a storage: the ID of the source and the versions of both storages right after the copy
+//Both storages were equal at that point, so everything that differs now has been changed afterwards in one of them
+struct OverwriteRecord
+{
+    uint64_t SourceId;
+    uint32_t SourceVersion;
+    uint32_t Version;
+
+    inline void Reset()
+    {
+        SourceId = 0;
+        SourceVersion = 0;
+        Version = 0;
+    }
+
+    //Checks whether the last overwrite was done from the given source
+    inline bool IsFrom(uint64_t sourceId) const
+    {
+        return SourceId == sourceId;
+    }
+
+    //Checks whether the last overwrite was done from the given source and neither storage changed since then
+    inline bool IsUnchanged(uint64_t sourceId, uint32_t sourceChangedVersion, uint32_t changedVersion) const
+    {
+        return IsFrom(sourceId) && sourceChangedVersion <= SourceVersion && changedVersion <= Version;
+    }
+};
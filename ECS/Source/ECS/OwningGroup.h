@@ -0,0 +1,135 @@
+#pragma once
+
+#include "ECSSettings.h"
+#include "TypeList.h"
+#include "ComponentCollection.h"
+#include "ThreadPool.h"
+
+#include <cassert>
+#include <tuple>
+#include <utility>
+
+//Keeps the entities that have all owned components packed at the front of the owned collections in the same dense order
+//The group is iterated as parallel arrays without any sparse lookup
+//A system declares a group as public member 'Group' and the SystemManager keeps it in sync with the entities of the system,
+//so the owned components need to be part of the required components of the system. Each component can only be owned by one group
+//Only the group size is part of the state, the dense order itself is stored in the collections
+template<uint32_t Capacity, typename... T>
+class OwningGroup
+{
+    static_assert(sizeof...(T) > 0, "A group needs to own at least one component type");
+    static_assert((!HasFieldList<T> && ...), "Components with a field list can not be owned by a group");
+
+    using Indices = std::index_sequence_for<T...>;
+
+public:
+    using OwnedComponents = TypeList<T...>;
+
+    explicit OwningGroup(ComponentCollection<T, Capacity>*... collections) : collections(collections...), size(0) { }
+
+    //Only copies the group size, the owned collections are overwritten by the component manager
+    void Overwrite(const OwningGroup& other)
+    {
+        size = other.size;
+    }
+
+    //Empties the group, used when the owned collections are cleared
+    void Clear()
+    {
+        size = 0;
+    }
+
+    //Moves the entity to the end of the group in all owned collections. The entity needs to have all owned components
+    void Insert(Entity entity)
+    {
+        assert(!Contains(entity) && "Entity is already part of the group");
+        SwapInAll(entity, size, Indices());
+        size++;
+    }
+
+    //Moves the entity behind the group in all owned collections, before any owned component of the entity gets removed
+    void Erase(Entity entity)
+    {
+        if (!Contains(entity)) return;
+
+        size--;
+        SwapInAll(entity, size, Indices());
+    }
+
+    inline bool Contains(Entity entity) const
+    {
+        const ComponentCollection<First, Capacity>* collection = std::get<0>(collections);
+        return collection->HasComponent(entity) && collection->GetIndex(entity) < size;
+    }
+
+    //Calls func(entity, components&...) for every entity of the group and marks the owned components of the group as changed
+    template<typename Func>
+    void ForEach(Func&& func) const
+    {
+        ForEach(func, 0, size, Indices());
+        MarkChanged(Indices());
+    }
+
+    //Calls func(entity, components&...) for every entity of the group, split over the thread pool in chunks of ParallelChunkSize
+    //func should only write the components of its own entity, then the result is the same as ForEach
+    template<typename Func>
+    void ForEachParallel(ThreadPool& threadPool, Func&& func) const
+    {
+        threadPool.ParallelFor(size, ParallelChunkSize, [this, &func](uint32_t begin, uint32_t end) { ForEach(func, begin, end, Indices()); });
+        MarkChanged(Indices());
+    }
+
+    //Incrementally sorts the group by getKey(entity, components&...) in all owned collections with at most maxSwaps swaps. Returns true when the group is sorted
+    template<typename KeyFunc>
+    bool Sort(KeyFunc&& getKey, uint32_t maxSwaps)
+    {
+        return Sort(getKey, maxSwaps, Indices());
+    }
+
+    uint32_t Size() const
+    {
+        return size;
+    }
+
+private:
+    using First = std::tuple_element_t<0, std::tuple<T...>>;
+
+    template<size_t... I>
+    inline void SwapInAll(Entity entity, uint32_t index, std::index_sequence<I...>)
+    {
+        (std::get<I>(collections)->SwapIndexes(std::get<I>(collections)->GetIndex(entity), index), ...);
+    }
+
+    template<typename KeyFunc, size_t... I>
+    bool Sort(KeyFunc& getKey, uint32_t maxSwaps, std::index_sequence<I...>)
+    {
+        const Entity* entities = std::get<0>(collections)->GetEntities();
+        const std::tuple<T*...> components(std::get<I>(collections)->GetComponents()...);
+
+        return IncrementalSort(size, maxSwaps,
+            [&](uint32_t index) { return getKey(entities[index], std::get<I>(components)[index]...); },
+            [this](uint32_t index1, uint32_t index2) { (std::get<I>(collections)->SwapIndexes(index1, index2), ...); });
+    }
+
+    template<typename Func, size_t... I>
+    void ForEach(Func& func, uint32_t begin, uint32_t end, std::index_sequence<I...>) const
+    {
+        const Entity* entities = std::get<0>(collections)->GetEntities();
+        const std::tuple<T*...> components(std::get<I>(collections)->GetComponents()...);
+
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            func(entities[i], std::get<I>(components)[i]...);
+        }
+    }
+
+    template<size_t... I>
+    void MarkChanged(std::index_sequence<I...>) const
+    {
+        (std::get<I>(collections)->MarkIndexesChanged(0, size), ...);
+    }
+
+private:
+    std::tuple<ComponentCollection<T, Capacity>*...> collections;
+    uint32_t size;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "ECSSettings.h"
+#include "TypeList.h"
+#include "ComponentManager.h"
+
+#include <bitset>
+#include <cassert>
+#include <tuple>
+
+template<typename ComponentList>
+class Prefab;
+
+//A prebuilt set of components that Layer::Instantiate stamps onto new entities
+//Expensive values (mass, inertia, geometry) are computed once when the prefab is built instead of for every entity
+//Instantiating appends to every component collection once and inserts each entity into its systems once, instead of one update per component
+//Values that differ per entity are set on the created entities afterwards, or on the prefab between two instantiations
+template<typename... Component>
+class Prefab<ComponentList<Component...>>
+{
+    using Components = ComponentList<Component...>;
+    using Signature = std::bitset<Count_v<Components>>;
+
+public:
+    //Sets the component of type T, tags only set their signature bit
+    template<typename T>
+    Prefab& Set(const T& component)
+    {
+        static_assert(Contains_v<T, Components>, "Component T is not part of the specified components");
+
+        if constexpr (!TagComponent<T>)
+        {
+            std::get<T>(components) = component;
+        }
+
+        signature.set(IndexOf_v<T, Components>);
+        return *this;
+    }
+
+    template<typename T>
+    void Remove()
+    {
+        static_assert(Contains_v<T, Components>, "Component T is not part of the specified components");
+        signature.reset(IndexOf_v<T, Components>);
+    }
+
+    template<typename T>
+    bool Has() const
+    {
+        static_assert(Contains_v<T, Components>, "Component T is not part of the specified components");
+        return signature.test(IndexOf_v<T, Components>);
+    }
+
+    template<typename T>
+    T& Get()
+    {
+        static_assert(!TagComponent<T>, "Tags have no data");
+        assert(Has<T>() && "The prefab does not have the component");
+        return std::get<T>(components);
+    }
+
+    template<typename T>
+    const T& Get() const
+    {
+        static_assert(!TagComponent<T>, "Tags have no data");
+        assert(Has<T>() && "The prefab does not have the component");
+        return std::get<T>(components);
+    }
+
+    Signature GetSignature() const
+    {
+        return signature;
+    }
+
+private:
+    std::tuple<Component...> components { };
+    Signature signature;
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "ECSSettings.h"
+#include "EntityManager.h"
+#include "EntitySet.h"
+
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using QueryId = uint32_t;
+
+//Holds the queries that are created at runtime. A query is a signature of required components and a signature of excluded components
+//Each query keeps its matching entities in an entity set that is updated with every signature change, so reading it never scans the entities
+//The queries are not part of the layer state. After the layer is overwritten or cleared they are rebuilt from the active entities the next time they are read
+template<uint8_t ComponentCount, uint32_t Capacity>
+class QueryManager
+{
+    using Signature = std::bitset<ComponentCount>;
+
+    struct Query
+    {
+        Signature Required;
+        Signature Excluded;
+        bool Stale;
+        EntitySet<Capacity> Entities;
+
+        inline bool Matches(Signature signature) const
+        {
+            return (signature & Required) == Required && (signature & Excluded).none();
+        }
+    };
+
+public:
+    //Creates the query and fills it with the matching active entities. The IDs of destroyed queries are reused
+    QueryId Create(Signature required, Signature excluded, const EntityManager<ComponentCount, Capacity>& entityManager)
+    {
+        assert(required.any() && "A query needs at least one required component");
+        assert((required & excluded).none() && "A query can not require and exclude the same component");
+
+        QueryId id = static_cast<QueryId>(queries.size());
+
+        if (!freeIds.empty())
+        {
+            id = freeIds.back();
+            freeIds.pop_back();
+        }
+        else
+        {
+            queries.emplace_back();
+        }
+
+        queries[id] = std::make_unique<Query>();
+        Query& query = *queries[id];
+        query.Required = required;
+        query.Excluded = excluded;
+        query.Entities.Initialize();
+        Rebuild(query, entityManager);
+
+        return id;
+    }
+
+    void Destroy(QueryId id)
+    {
+        assert(id < queries.size() && queries[id] && "Query does not exist");
+
+        queries[id].reset();
+        freeIds.push_back(id);
+    }
+
+    //Gets the matching entities of the query, a stale query is rebuilt first
+    const EntitySet<Capacity>& Get(QueryId id, const EntityManager<ComponentCount, Capacity>& entityManager)
+    {
+        assert(id < queries.size() && queries[id] && "Query does not exist");
+
+        Query& query = *queries[id];
+
+        if (query.Stale)
+        {
+            Rebuild(query, entityManager);
+        }
+
+        return query.Entities;
+    }
+
+    //Only the queries that require or exclude a changed component can change their membership
+    inline void SignatureChanged(Entity entity, Signature oldSignature, Signature newSignature)
+    {
+        if (queries.empty()) return;
+
+        const Signature changed = oldSignature ^ newSignature;
+
+        for (const std::unique_ptr<Query>& query : queries)
+        {
+            if (!query || query->Stale || (changed & (query->Required | query->Excluded)).none()) continue;
+
+            if (query->Matches(newSignature))
+            {
+                query->Entities.Insert(entity);
+            }
+            else
+            {
+                query->Entities.Erase(entity);
+            }
+        }
+    }
+
+    //The entities were replaced as a whole, the queries are rebuilt when they are read again
+    void Invalidate()
+    {
+        for (const std::unique_ptr<Query>& query : queries)
+        {
+            if (query) query->Stale = true;
+        }
+    }
+
+private:
+    void Rebuild(Query& query, const EntityManager<ComponentCount, Capacity>& entityManager)
+    {
+        query.Entities.Clear();
+
+        for (const Entity entity : entityManager.GetActiveEntities())
+        {
+            if (query.Matches(entityManager.GetSignature(entity)))
+            {
+                query.Entities.Insert(entity);
+            }
+        }
+
+        query.Stale = false;
+    }
+
+private:
+    std::vector<std::unique_ptr<Query>> queries;
+    std::vector<QueryId> freeIds;
+};
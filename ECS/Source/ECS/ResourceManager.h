@@ -0,0 +1,91 @@
+#pragma once
+
+#include "ECSSettings.h"
+#include "TypeList.h"
+#include "OverwriteRecord.h"
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+template<typename... Resource>
+using ResourceList = TypeList<Resource...>;
+
+template<typename ResourceList>
+class ResourceManager;
+
+//Stores one instance of every resource type, the state of a layer that does not belong to an entity (current frame, random generator, caches)
+//The resources are part of the layer state, so they are saved and restored with the entities by Layer::Overwrite
+//Every resource remembers the version of its last mutable access. Overwriting from the same manager as last time only copies
+//the resources that changed in one of both managers since then, so a resource that is rarely written is not copied every frame
+//Writing through a reference that was taken earlier does not mark the resource as changed, use MarkChanged for that
+template<typename... Resource>
+class ResourceManager<ResourceList<Resource...>>
+{
+    using Resources = ResourceList<Resource...>;
+    static constexpr size_t ResourceCount = sizeof...(Resource);
+
+public:
+    ResourceManager() : resources(), storageId(NextStorageId())
+    {
+        changedVersions.fill(version);
+    }
+
+    void Overwrite(const ResourceManager& other)
+    {
+        [[maybe_unused]] const bool sameSource = record.IsFrom(other.storageId);   //Unused when the layer has no resources
+        (OverwriteResource<Resource>(other, sameSource), ...);
+
+        record = { other.storageId, other.version++, version++ };
+    }
+
+    //Gets the resource and marks it as changed
+    template<typename T>
+    T& GetResource()
+    {
+        MarkChanged<T>();
+        return std::get<T>(resources);
+    }
+
+    //Gets the resource without marking it as changed
+    template<typename T>
+    const T& GetResource() const
+    {
+        return std::get<T>(resources);
+    }
+
+    template<typename T>
+    void SetResource(const T& resource)
+    {
+        GetResource<T>() = resource;
+    }
+
+    template<typename T>
+    void MarkChanged()
+    {
+        static_assert(Contains_v<T, Resources>, "Resource T is not part of the specified resources");
+        changedVersions[IndexOf_v<T, Resources>] = version;
+    }
+
+private:
+    template<typename T>
+    inline void OverwriteResource(const ResourceManager& other, bool sameSource)
+    {
+        constexpr size_t index = IndexOf_v<T, Resources>;
+
+        if (!sameSource || other.changedVersions[index] > record.SourceVersion || changedVersions[index] > record.Version)
+        {
+            std::get<T>(resources) = std::get<T>(other.resources);
+            changedVersions[index] = version;
+        }
+    }
+
+private:
+    std::tuple<Resource...> resources;
+    std::array<uint32_t, ResourceCount> changedVersions;
+
+    uint64_t storageId;
+    mutable uint32_t version { 1 };    //Also advanced by the managers that overwrite themselves with this manager
+    OverwriteRecord record { };
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "ECSSettings.h"
+
+#include <array>
+#include <cassert>
+#include <memory>
+#include <type_traits>
+
+//Sparse arrays map an entity to an index of a dense array. Entities without an index map to ENTITYNULL
+
+//Stores the indexes of all entities in one array
+template<uint32_t Capacity>
+class FlatSparseArray
+{
+public:
+    inline FlatSparseArray() noexcept = default;
+
+    inline void Initialize()
+    {
+        indexes.fill(ENTITYNULL);
+    }
+
+    inline uint32_t Get(Entity entity) const
+    {
+        assert(entity < Capacity && "Entity out of range");
+        return indexes[entity];
+    }
+
+    inline void Set(Entity entity, uint32_t index)
+    {
+        assert(entity < Capacity && "Entity out of range");
+        indexes[entity] = index;
+    }
+
+    inline void Reset(Entity entity)
+    {
+        Set(entity, ENTITYNULL);
+    }
+
+private:
+    std::array<uint32_t, Capacity> indexes;
+};
+
+//Stores the indexes in pages of 4 KB that are only allocated when an entity of the page gets an index
+//The memory follows the used entities instead of the capacity. Pages stay allocated until the array is initialized again
+template<uint32_t Capacity>
+class PagedSparseArray
+{
+    static constexpr uint32_t PageCount = (Capacity + SparsePageSize - 1) / SparsePageSize;
+
+    using Page = std::array<uint32_t, SparsePageSize>;
+
+public:
+    PagedSparseArray() = default;
+
+    inline void Initialize()
+    {
+        for (std::unique_ptr<Page>& page : pages)
+        {
+            page.reset();
+        }
+    }
+
+    inline uint32_t Get(Entity entity) const
+    {
+        assert(entity < Capacity && "Entity out of range");
+
+        const std::unique_ptr<Page>& page = pages[entity / SparsePageSize];
+        return page ? (*page)[entity % SparsePageSize] : ENTITYNULL;
+    }
+
+    inline void Set(Entity entity, uint32_t index)
+    {
+        assert(entity < Capacity && "Entity out of range");
+
+        std::unique_ptr<Page>& page = pages[entity / SparsePageSize];
+
+        if (!page)
+        {
+            page = std::make_unique<Page>();
+            page->fill(ENTITYNULL);
+        }
+
+        (*page)[entity % SparsePageSize] = index;
+    }
+
+    inline void Reset(Entity entity)
+    {
+        assert(entity < Capacity && "Entity out of range");
+
+        std::unique_ptr<Page>& page = pages[entity / SparsePageSize];
+
+        if (page)
+        {
+            (*page)[entity % SparsePageSize] = ENTITYNULL;
+        }
+    }
+
+    //Amount of pages that are allocated
+    uint32_t GetPageCount() const
+    {
+        uint32_t count = 0;
+
+        for (const std::unique_ptr<Page>& page : pages)
+        {
+            count += page != nullptr;
+        }
+
+        return count;
+    }
+
+private:
+    std::array<std::unique_ptr<Page>, PageCount> pages { };
+};
+
+//Small capacities use a flat array, which keeps the sparse sets trivial. Larger capacities use pages
+template<uint32_t Capacity>
+using SparseArray = std::conditional_t<(Capacity > PagedSparseArrayThreshold), PagedSparseArray<Capacity>, FlatSparseArray<Capacity>>;
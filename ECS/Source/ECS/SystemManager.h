@@ -3,26 +3,42 @@
 #include "ECSSettings.h"
 #include "TypeList.h"
 #include "ComponentManager.h"
+#include "EntitySet.h"
 
 #include <array>
 #include <cassert>
+#include <span>
+#include <type_traits>
 
 template<typename... System>
 using SystemList = TypeList<System...>;
 
-template<typename ComponentList, typename SystemList>
+template<typename ComponentList, typename SystemList, uint32_t Capacity = MAXENTITIES>
 class SystemManager;
 
 //Manages the systems, their signatures and gives functionality to automatically adding components to a system when their signature match (or not)
-template<typename... Component, typename... System>
-class SystemManager<ComponentList<Component...>, SystemList<System...>>
+//A system holds the entities that have all of its 'RequiredComponents' and, when declared, none of its 'ExcludedComponents'
+template<typename... Component, typename... System, uint32_t Capacity>
+class SystemManager<ComponentList<Component...>, SystemList<System...>, Capacity>
 {
+	static_assert((std::is_same_v<decltype(System::Entities), EntitySet<Capacity>> && ...), "The entity set of each system needs to have the capacity of the layer");
+
+	//Systems with an owning group
+	template<typename T>
+	static constexpr bool HasGroup = requires { T::Group; };
+
+	//Systems that exclude components
+	template<typename T>
+	static constexpr bool HasExclusions = requires { typename T::ExcludedComponents; };
+
 	using Components = ComponentList<Component...>;
 	using Systems = SystemList<System...>;
 	using Signature = std::bitset<Count_v<Components>>;
 
 public:
-	explicit SystemManager(ComponentManager<Components>& componentManager)
+	//The component storage is either a ComponentManager or an ArchetypeManager and is passed to the constructor of each system
+	template<typename ComponentStorage>
+	explicit SystemManager(ComponentStorage& componentManager)
 	{
 		(RegisterSystem<System>(componentManager), ...);
 	}
@@ -51,18 +67,57 @@ public:
 		return reinterpret_cast<const T*>(Data.data() + SystemOffset<T>);
 	}
 
+    //Removes all entities from all systems
+	void Clear()
+	{
+		(ClearSystem<System>(), ...);
+	}
+
     //Removes the given entity from all systems that have a reference to the entity
-	void DestroyEntity(Entity entity)
+	void DestroyEntity([[maybe_unused]] Entity entity)
 	{
 		(DestroyEntityForSystem<System>(entity), ...);
 	}
 
-    //Compares the new entity signature to all system signatures
-    //When the signatures match the entity gets added to the system entity set
-    //When the signatures do not match the entity gets removes from the system entity set
-	void EntitySignatureChanged(Entity entity, Signature newSignature) //TODO: test with random removals
+    //Removes the given entities from all systems, one system after another
+	void DestroyEntities([[maybe_unused]] std::span<const Entity> entities)
+	{
+		(DestroyEntitiesForSystem<System>(entities), ...);
+	}
+
+    //Compares the old and new entity signature to the signatures of the systems that require or exclude a changed component
+    //The entity is only inserted into or erased from a system entity set when its membership changes
+	void EntitySignatureChanged([[maybe_unused]] Entity entity, Signature oldSignature, Signature newSignature)
+	{
+		const Signature changed = oldSignature ^ newSignature;
+
+		if (changed.none()) return;
+
+		(EntitySignatureChangedForSystem<System>(entity, changed, newSignature), ...);
+	}
+
+    //Like EntitySignatureChanged for entities that share the old and the new signature. The membership of each system is only decided once
+	void EntitiesSignatureChanged([[maybe_unused]] std::span<const Entity> entities, Signature oldSignature, Signature newSignature)
+	{
+		const Signature changed = oldSignature ^ newSignature;
+
+		if (changed.none()) return;
+
+		(EntitiesSignatureChangedForSystem<System>(entities, changed, oldSignature, newSignature), ...);
+	}
+
+    //Called after component T was added to the entity. Only the systems that require or exclude T are checked, which is decided at compile time
+	template<typename T>
+	void ComponentAdded([[maybe_unused]] Entity entity, [[maybe_unused]] Signature newSignature)
+	{
+		(ComponentAddedForSystem<T, System>(entity, newSignature), ...);
+	}
+
+    //Called before component T is removed from the entity. Only the systems that require or exclude T are checked, which is decided at compile time
+	template<typename T>
+	void ComponentRemoved([[maybe_unused]] Entity entity, [[maybe_unused]] Signature oldSignature)
 	{
-		(EntitySignatureChangedForSystem<System>(entity, newSignature), ...);
+		(ComponentRemovedForSystem<T, System>(entity, oldSignature), ...);
 	}
 
 	template<typename T>
@@ -80,8 +135,8 @@ public:
 	}
 
 private:
-	template<typename T>
-	inline void RegisterSystem(ComponentManager<Components>& componentManager)
+	template<typename T, typename ComponentStorage>
+	inline void RegisterSystem(ComponentStorage& componentManager)
 	{
 		new (&Data[SystemOffset<T>]) T(componentManager);
 	}
@@ -89,33 +144,159 @@ private:
 	template<typename T>
 	inline void OverrideSystem(const SystemManager& other)
 	{
-		GetSystem<T>()->Entities = other.GetSystem<T>()->Entities;
+		GetSystem<T>()->Entities.Overwrite(other.GetSystem<T>()->Entities);
+
+		if constexpr (HasGroup<T>)
+		{
+			GetSystem<T>()->Group.Overwrite(other.GetSystem<T>()->Group);
+		}
+	}
+
+	template<typename T>
+	inline void ClearSystem()
+	{
+		GetSystem<T>()->Entities.Clear();
+
+		if constexpr (HasGroup<T>)
+		{
+			GetSystem<T>()->Group.Clear();
+		}
 	}
 
+	//Needs to be called before the components of the entity are removed, so the group can move the entity out of the group
 	template<typename T>
 	inline void DestroyEntityForSystem(Entity entity)
 	{
+		if constexpr (HasGroup<T>)
+		{
+			GetSystem<T>()->Group.Erase(entity);
+		}
+
 		GetSystem<T>()->Entities.Erase(entity);
 	}
 
 	template<typename T>
-	inline void EntitySignatureChangedForSystem(Entity entity, Signature newSignature)
+	inline void DestroyEntitiesForSystem(std::span<const Entity> entities)
+	{
+		for (const Entity entity : entities)
+		{
+			DestroyEntityForSystem<T>(entity);
+		}
+	}
+
+	template<typename T>
+	inline void InsertForSystem(Entity entity)
 	{
 		T* system = GetSystem<T>();
-		constexpr Signature signature = SystemSignature<T>;
+		bool inserted = system->Entities.Insert(entity);
+
+		if constexpr (HasGroup<T>)
+		{
+			if (inserted) system->Group.Insert(entity);
+		}
+	}
+
+	template<typename T>
+	inline void EntitySignatureChangedForSystem(Entity entity, Signature changed, Signature newSignature)
+	{
+		constexpr Signature signature = SystemSignature<T> | ExcludedSignature<T>;
+
+		//None of the required or excluded components changed, so the membership is the same
+		if ((changed & signature).none()) return;
 
-		if ((newSignature & signature) == signature)
+		if (Matches<T>(newSignature))
 		{
-			//Entity signature matches system signature - insert into set
-			system->Entities.Insert(entity);
+			InsertForSystem<T>(entity);
 		}
 		else
 		{
-			//Entity signature does not match system signature - erase from set
-			system->Entities.Erase(entity);
+			DestroyEntityForSystem<T>(entity);
+		}
+	}
+
+	template<typename T>
+	inline void EntitiesSignatureChangedForSystem(std::span<const Entity> entities, Signature changed, Signature oldSignature, Signature newSignature)
+	{
+		constexpr Signature signature = SystemSignature<T> | ExcludedSignature<T>;
+
+		if ((changed & signature).none()) return;
+
+		const bool matched = Matches<T>(oldSignature);
+		const bool matches = Matches<T>(newSignature);
+
+		if (matched == matches) return;
+
+		for (const Entity entity : entities)
+		{
+			if (matches)
+			{
+				InsertForSystem<T>(entity);
+			}
+			else
+			{
+				DestroyEntityForSystem<T>(entity);
+			}
+		}
+	}
+
+	//Adding a required component can only make the entity enter the system and adding an excluded component can only make it leave
+	template<typename Added, typename T>
+	inline void ComponentAddedForSystem(Entity entity, Signature newSignature)
+	{
+		if constexpr (RequiresComponent<T, Added>)
+		{
+			if (Matches<T>(newSignature))
+			{
+				InsertForSystem<T>(entity);
+			}
+		}
+		else if constexpr (ExcludesComponent<T, Added>)
+		{
+			Signature oldSignature = newSignature;
+			oldSignature.reset(GetComponentType<Added>());
+
+			if (Matches<T>(oldSignature))
+			{
+				DestroyEntityForSystem<T>(entity);
+			}
+		}
+	}
+
+	//Removing a required component can only make the entity leave the system, when it was part of it, and removing an excluded component can only make it enter
+	template<typename Removed, typename T>
+	inline void ComponentRemovedForSystem(Entity entity, Signature oldSignature)
+	{
+		if constexpr (RequiresComponent<T, Removed>)
+		{
+			if (Matches<T>(oldSignature))
+			{
+				DestroyEntityForSystem<T>(entity);
+			}
+		}
+		else if constexpr (ExcludesComponent<T, Removed>)
+		{
+			Signature newSignature = oldSignature;
+			newSignature.reset(GetComponentType<Removed>());
+
+			if (Matches<T>(newSignature))
+			{
+				InsertForSystem<T>(entity);
+			}
 		}
 	}
 
+	template<typename T>
+	static constexpr bool Matches(Signature signature)
+	{
+		return (signature & SystemSignature<T>) == SystemSignature<T> && (signature & ExcludedSignature<T>).none();
+	}
+
+	template<typename C>
+	static constexpr ComponentType GetComponentType()
+	{
+		return ComponentManager<Components>::template GetComponentType<C>();
+	}
+
 private:
 	static constexpr ComponentType ComponentCount = Count_v<Components>;
 	static constexpr SystemType SystemCount = Count_v<Systems>;
@@ -142,5 +323,31 @@ private:
 	template<typename T>
 	static constexpr Signature SystemSignature =  SignatureHelper<typename T::RequiredComponents>::Get();
 
+	template<typename T>
+	static constexpr Signature ExcludedSignature = []
+	{
+		if constexpr (HasExclusions<T>) return SignatureHelper<typename T::ExcludedComponents>::Get();
+		else return Signature();
+	}();
+
+	//Which systems can be affected by a change of component C
+	template<typename T, typename C>
+	static constexpr bool RequiresComponent = SystemSignature<T>.test(GetComponentType<C>());
+
+	template<typename T, typename C>
+	static constexpr bool ExcludesComponent = ExcludedSignature<T>.test(GetComponentType<C>());
+
+	template<typename T>
+	static constexpr Signature GroupSignature = []
+	{
+		if constexpr (HasGroup<T>) return SignatureHelper<typename decltype(T::Group)::OwnedComponents>::Get();
+		else return Signature();
+	}();
+
+	//Owned components need to be required by the system and can only be owned by one group
+	static_assert((((GroupSignature<System> & SystemSignature<System>) == GroupSignature<System>) && ...), "A group can only own components that are required by its system");
+	static_assert((GroupSignature<System>.count() + ... + 0) == (GroupSignature<System> | ... | Signature()).count(), "A component can only be owned by one group");
+	static_assert(((SystemSignature<System> & ExcludedSignature<System>).none() && ...), "A system can not require and exclude the same component");
+
 	alignas(64) std::array<uint8_t, TotalSize> Data;
 };
\ No newline at end of file
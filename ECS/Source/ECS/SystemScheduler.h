@@ -0,0 +1,200 @@
+#pragma once
+
+#include "ECSSettings.h"
+#include "TypeList.h"
+#include "ComponentManager.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+//Systems can declare how they access their components with 'using ReadComponents = ComponentList<...>' and 'using WriteComponents = ComponentList<...>'
+//Reading only allows const access (const views, const GetComponent, ChangedSince), because mutable access marks the components as changed
+//Systems without a declaration are treated as writing all their required components
+template<typename T>
+concept DeclaresComponentAccess = requires { typename T::ReadComponents; } || requires { typename T::WriteComponents; };
+
+template<typename T>
+struct SystemAccess
+{
+    using Read = ComponentList<>;
+    using Write = typename T::RequiredComponents;
+};
+
+template<DeclaresComponentAccess T>
+struct SystemAccess<T>
+{
+    using Read = decltype([]
+    {
+        if constexpr (requires { typename T::ReadComponents; }) return typename T::ReadComponents();
+        else return ComponentList<>();
+    }());
+
+    using Write = decltype([]
+    {
+        if constexpr (requires { typename T::WriteComponents; }) return typename T::WriteComponents();
+        else return ComponentList<>();
+    }());
+};
+
+template<typename ComponentList>
+class SystemScheduler;
+
+//Runs the added system tasks on a thread pool. Each task is added for a system and gets the component access of that system
+//A task depends on every earlier task it conflicts with (one of both writes a component the other one reads or writes)
+//Conflicting tasks always run in the order in which they were added and tasks without a conflict never touch the same components,
+//so the results are the same as running all tasks one after another, independent of the thread count and the timing
+//The schedule is built once and can be run every frame. Tasks should read their per-frame parameters from state that is set before Run()
+//When every task conflicts with the task before it, no two tasks can run at the same time and Run() executes them on the calling thread
+template<typename... Component>
+class SystemScheduler<ComponentList<Component...>>
+{
+    using Components = ComponentList<Component...>;
+    using Signature = std::bitset<Count_v<Components>>;
+
+    struct Task
+    {
+        Signature Read;
+        Signature Write;
+        std::function<void()> Function;
+        std::vector<uint32_t> Dependents;
+        uint32_t DependencyCount;
+    };
+
+public:
+    explicit SystemScheduler(ThreadPool& threadPool) : threadPool(threadPool) { }
+
+    //Adds a task that accesses the components like the given system
+    template<typename System, typename Func>
+    void Add(Func&& func)
+    {
+        Signature write = GetSignature(typename SystemAccess<System>::Write());
+        Signature read = GetSignature(typename SystemAccess<System>::Read()) & ~write;
+
+        Task task { read, write, std::function<void()>(std::forward<Func>(func)), { }, 0 };
+
+        const uint32_t index = static_cast<uint32_t>(tasks.size());
+
+        for (uint32_t i = 0; i < index; ++i)
+        {
+            if (Conflicts(tasks[i], task))
+            {
+                tasks[i].Dependents.push_back(index);
+                task.DependencyCount++;
+            }
+        }
+
+        if (index > 0 && !Conflicts(tasks[index - 1], task))
+        {
+            chained = false;
+        }
+
+        tasks.push_back(std::move(task));
+        remainingDependencies = std::make_unique<std::atomic<uint32_t>[]>(tasks.size());
+    }
+
+    void Clear()
+    {
+        tasks.clear();
+        remainingDependencies.reset();
+        chained = true;
+    }
+
+    //Runs all tasks and returns when they are finished. The calling thread helps executing the tasks
+    void Run()
+    {
+        if (tasks.empty()) return;
+
+        //The tasks form a single chain, handing them to the pool would only add the latency of a thread hop
+        if (chained)
+        {
+            for (Task& task : tasks)
+            {
+                task.Function();
+            }
+
+            return;
+        }
+
+        unfinishedCount = static_cast<uint32_t>(tasks.size());
+
+        for (uint32_t i = 0; i < tasks.size(); ++i)
+        {
+            remainingDependencies[i] = tasks[i].DependencyCount;
+        }
+
+        for (uint32_t i = 0; i < tasks.size(); ++i)
+        {
+            if (tasks[i].DependencyCount == 0)
+            {
+                Submit(i);
+            }
+        }
+
+        while (unfinishedCount > 0)
+        {
+            if (!threadPool.RunPendingTask())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    uint32_t GetTaskCount() const
+    {
+        return static_cast<uint32_t>(tasks.size());
+    }
+
+    //Whether every task has to wait for the task before it, then Run() does not use the thread pool
+    bool IsChained() const
+    {
+        return chained;
+    }
+
+private:
+    template<typename... C>
+    static constexpr Signature GetSignature(ComponentList<C...>)
+    {
+        static_assert((Contains_v<C, Components> && ...), "The system accesses a component that is not part of the specified components");
+
+        Signature signature;
+        (signature.set(IndexOf_v<C, Components>), ...);
+        return signature;
+    }
+
+    static bool Conflicts(const Task& earlier, const Task& later)
+    {
+        return (earlier.Write & (later.Read | later.Write)).any() || (earlier.Read & later.Write).any();
+    }
+
+    void Submit(uint32_t index)
+    {
+        threadPool.Submit([this, index] { Execute(index); });
+    }
+
+    void Execute(uint32_t index)
+    {
+        tasks[index].Function();
+
+        for (const uint32_t dependent : tasks[index].Dependents)
+        {
+            if (--remainingDependencies[dependent] == 0)
+            {
+                Submit(dependent);
+            }
+        }
+
+        unfinishedCount--;
+    }
+
+private:
+    ThreadPool& threadPool;
+    std::vector<Task> tasks;
+    std::unique_ptr<std::atomic<uint32_t>[]> remainingDependencies;
+    std::atomic<uint32_t> unfinishedCount { 0 };
+    bool chained = true;
+};
@@ -0,0 +1,645 @@
+#pragma once
+
+#include "ECS.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//Tests the parts of the ECS that the physics layer does not reach. The checks are asserts, so run them in a debug build
+class TestECS
+{
+public:
+    TestECS() = default;
+
+    struct Position
+    {
+        int32_t X;
+        int32_t Y;
+    };
+
+    struct Velocity
+    {
+        int32_t X;
+        int32_t Y;
+    };
+
+    struct Frozen { };
+
+    //Stored as a struct of arrays, one aligned array per field
+    struct Particle
+    {
+        Velocity Speed;
+        int32_t Lifetime;
+        int64_t Seed;
+
+        using Fields = FieldList<&Particle::Speed, &Particle::Lifetime, &Particle::Seed>;
+    };
+
+    static constexpr uint32_t TestCapacity = 4096;
+    static constexpr uint32_t PagedCapacity = 10000;    //Above PagedSparseArrayThreshold, so the sparse sets use pages
+
+    using TestComponents = ComponentList<Position, Velocity, Frozen>;
+    using TestArchetypeManager = ArchetypeManager<TestComponents, TestCapacity>;
+
+    //Moves its entities by walking the archetype chunks as arrays
+    class ChunkMovementSystem
+    {
+    public:
+        using RequiredComponents = ComponentList<Position, Velocity>;
+
+        explicit ChunkMovementSystem(TestArchetypeManager& archetypeManager) : archetypeManager(&archetypeManager)
+        {
+            Entities.Initialize();
+        }
+
+        void Update()
+        {
+            archetypeManager->ForEachChunk<Position, Velocity>([](uint32_t count, const Entity*, Position* positions, Velocity* velocities)
+            {
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    positions[i].X += velocities[i].X;
+                    positions[i].Y += velocities[i].Y;
+                }
+            });
+        }
+
+    private:
+        TestArchetypeManager* archetypeManager;
+
+    public:
+        EntitySet<TestCapacity> Entities;
+    };
+
+    using TestArchetypeLayer = Layer<TestComponents, SystemList<ChunkMovementSystem>, TestCapacity, StorageMode::Archetype>;
+
+    //Holds the moving entities of a sparse set layer, frozen entities are excluded
+    class MovementSystem
+    {
+    public:
+        using RequiredComponents = ComponentList<Position, Velocity>;
+        using ExcludedComponents = ComponentList<Frozen>;
+
+        explicit MovementSystem(ComponentManager<TestComponents, TestCapacity>&)
+        {
+            Entities.Initialize();
+        }
+
+    public:
+        EntitySet<TestCapacity> Entities;
+    };
+
+    using TestSystemLayer = Layer<TestComponents, SystemList<MovementSystem>, TestCapacity>;
+
+    //A layer without systems, the views are created directly on the component manager
+    using TestSparseSetLayer = Layer<TestComponents, SystemList<>, TestCapacity>;
+    using TestParticleLayer = Layer<ComponentList<Position, Particle>, SystemList<>, TestCapacity>;
+
+    static int Test()
+    {
+        std::cout << "Testing TestECS" << std::endl;
+
+        TestArchetypes();
+        TestParallelView();
+        TestFieldArrays();
+        TestOverwriteChain();
+        TestPagedSparseArrays();
+        TestQueries();
+        TestObservers();
+        TestCommandBuffer();
+        TestInstantiate();
+
+        return 0;
+    }
+
+    static void TestArchetypes()
+    {
+        std::unique_ptr<TestArchetypeLayer> layer = std::make_unique<TestArchetypeLayer>();
+        std::unique_ptr<TestArchetypeLayer> copy = std::make_unique<TestArchetypeLayer>();
+
+        //Enough entities to fill multiple chunks of the same archetype
+        constexpr int32_t count = 1000;
+        std::vector<Entity> entities;
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            Entity entity = layer->CreateEntity();
+            entities.push_back(entity);
+
+            layer->AddComponent(entity, Position { i, 0 });
+            if (i % 2 == 1) layer->AddComponent(entity, Velocity { 1, 2 });
+            if (i % 3 == 0) layer->AddComponent(entity, Frozen { });
+        }
+
+        assert(layer->GetSystem<ChunkMovementSystem>()->Entities.Size() == count / 2);
+
+        layer->GetSystem<ChunkMovementSystem>()->Update();
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            const Position& position = layer->GetComponent<Position>(entities[i]);
+            assert(position.X == i + (i % 2) && position.Y == 2 * (i % 2));
+            assert(layer->HasComponent<Frozen>(entities[i]) == (i % 3 == 0));
+        }
+
+        //Structural changes move the entities between archetypes and keep the chunks dense
+        CommandBuffer<TestComponents, TestCapacity> commands;
+
+        for (int32_t i = 0; i < count; i += 5)
+        {
+            if (i % 2 == 1) commands.RemoveComponent<Velocity>(entities[i]);
+        }
+
+        for (int32_t i = 0; i < count; i += 7)
+        {
+            commands.MarkEntityForDestruction(entities[i]);
+        }
+
+        layer->Apply(commands);
+
+        //The copy runs its own system over its own chunks
+        copy->Overwrite(*layer);
+        copy->GetSystem<ChunkMovementSystem>()->Update();
+
+        uint32_t moving = 0;
+
+        copy->ForEach<Position, Velocity>([&moving](Entity entity, const Position& position, const Velocity&)
+        {
+            const int32_t i = static_cast<int32_t>(entity);
+            assert(position.X == i + 2 && position.Y == 4);
+            moving++;
+        });
+
+        uint32_t expectedMoving = 0;
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            const bool destroyed = i % 7 == 0;
+            const bool hasVelocity = i % 2 == 1 && i % 5 != 0;
+            if (destroyed) continue;
+
+            expectedMoving += hasVelocity;
+            assert(copy->GetComponent<Position>(entities[i]).X == i + (i % 2) + hasVelocity);
+            assert(copy->HasComponent<Velocity>(entities[i]) == hasVelocity);
+        }
+
+        assert(moving == expectedMoving);
+        assert(copy->GetSystem<ChunkMovementSystem>()->Entities.Size() == expectedMoving);
+        assert(copy->GetEntityCount() == layer->GetEntityCount());
+    }
+
+    //The collections are filled in different orders, so the view looks the components up through the sparse sets on the worker threads
+    static void TestParallelView()
+    {
+        std::unique_ptr<TestSparseSetLayer> layer = std::make_unique<TestSparseSetLayer>();
+        ThreadPool threadPool(4);
+
+        constexpr int32_t count = 3000;
+        std::vector<Entity> entities;
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            entities.push_back(layer->CreateEntity());
+        }
+
+        for (int32_t i = count - 1; i >= 0; --i)
+        {
+            if (i % 4 != 0) layer->AddComponent(entities[i], Velocity { i, -i });
+        }
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            layer->AddComponent(entities[i], Position { 0, 0 });
+        }
+
+        ComponentCollection<Position, TestCapacity>* positions = layer->GetComponentCollection<Position>();
+        ComponentCollection<Velocity, TestCapacity>* velocities = layer->GetComponentCollection<Velocity>();
+        const uint32_t positionVersion = positions->MarkVersion();
+        const uint32_t velocityVersion = velocities->MarkVersion();
+
+        ComponentView<TestCapacity, Position, const Velocity> view = layer->View<Position, const Velocity>();
+        assert(!view.SharesOrdering());
+
+        constexpr int32_t frames = 10;
+
+        for (int32_t frame = 0; frame < frames; ++frame)
+        {
+            view.ForEachParallel(threadPool, [](Entity, Position& position, const Velocity& velocity)
+            {
+                position.X += velocity.X;
+                position.Y += velocity.Y;
+            });
+        }
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            const bool moved = i % 4 != 0;
+            const Position& position = std::as_const(*positions).GetComponent(entities[i]);
+
+            assert(position.X == (moved ? frames * i : 0) && position.Y == (moved ? -frames * i : 0));
+            assert(positions->HasChangedSince(entities[i], positionVersion) == moved);
+            assert(!moved || !velocities->HasChangedSince(entities[i], velocityVersion));
+        }
+    }
+
+    static void TestFieldArrays()
+    {
+        std::unique_ptr<TestParticleLayer> layer = std::make_unique<TestParticleLayer>();
+        std::unique_ptr<TestParticleLayer> copy = std::make_unique<TestParticleLayer>();
+
+        constexpr int32_t count = 300;
+        std::vector<Entity> entities;
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            Entity entity = layer->CreateEntity();
+            entities.push_back(entity);
+
+            auto particle = layer->AddComponent(entity, Particle { { i, 2 * i }, 0, i * 1000ll });
+            particle.Get<&Particle::Lifetime>() = 7;
+            layer->AddComponent(entity, Position { i, i });
+        }
+
+        //Removing moves the last components into the free slots, field by field
+        for (int32_t i = 0; i < count; i += 3)
+        {
+            layer->RemoveComponent<Particle>(entities[i]);
+        }
+
+        ComponentCollection<Particle, TestCapacity>* particles = layer->GetComponentCollection<Particle>();
+        std::span<Velocity> speeds = particles->GetField<&Particle::Speed>();
+        std::span<int32_t> lifetimes = particles->GetField<&Particle::Lifetime>();
+
+        assert(reinterpret_cast<uintptr_t>(speeds.data()) % 64 == 0 && reinterpret_cast<uintptr_t>(lifetimes.data()) % 64 == 0);
+        assert(speeds.size() == count - (count + 2) / 3);
+
+        for (uint32_t i = 0; i < speeds.size(); ++i)
+        {
+            speeds[i].X += 1;
+            lifetimes[i] -= 1;
+        }
+
+        particles->SortByEntity(count * count);
+        copy->Overwrite(*layer);
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            const bool hasParticle = i % 3 != 0;
+            assert(copy->HasComponent<Particle>(entities[i]) == hasParticle);
+
+            if (!hasParticle) continue;
+
+            const Particle particle = copy->GetComponent<Particle>(entities[i]);
+            assert(particle.Speed.X == i + 1 && particle.Speed.Y == 2 * i && particle.Lifetime == 6 && particle.Seed == i * 1000ll);
+        }
+
+        const ComponentCollection<Particle, TestCapacity>* copiedParticles = copy->GetComponentCollection<Particle>();
+
+        for (uint32_t i = 1; i < copiedParticles->GetEntityCount(); ++i)
+        {
+            assert(copiedParticles->GetEntities()[i - 1] < copiedParticles->GetEntities()[i]);
+        }
+    }
+
+    //Overwriting a layer from a source that was itself overwritten since the last time has to copy the entities again
+    static void TestOverwriteChain()
+    {
+        std::unique_ptr<TestSparseSetLayer> a = std::make_unique<TestSparseSetLayer>();
+        std::unique_ptr<TestSparseSetLayer> b = std::make_unique<TestSparseSetLayer>();
+        std::unique_ptr<TestSparseSetLayer> c = std::make_unique<TestSparseSetLayer>();
+
+        for (int32_t i = 0; i < 10; ++i)
+        {
+            b->AddComponent(b->CreateEntity(), Position { i, i });
+        }
+
+        for (int32_t i = 0; i < 25; ++i)
+        {
+            Entity entity = c->CreateEntity();
+            c->AddComponent(entity, Velocity { i, i });
+            if (i % 2 == 0) c->AddComponent(entity, Frozen { });
+        }
+
+        const std::vector<Entity> destroyed { 3, 4 };
+        c->DestroyEntities(destroyed);
+
+        a->Overwrite(*b);
+        b->Overwrite(*c);
+        a->Overwrite(*b);
+
+        assert(a->GetEntityCount() == c->GetEntityCount());
+
+        std::span<const Entity> activeEntities = a->GetActiveEntities();
+        std::span<const Entity> expectedEntities = c->GetActiveEntities();
+        assert(std::equal(activeEntities.begin(), activeEntities.end(), expectedEntities.begin(), expectedEntities.end()));
+
+        for (Entity entity = 0; entity < 25; ++entity)
+        {
+            assert(a->GetSignature(entity) == c->GetSignature(entity));
+        }
+
+        //The allocator is copied as well, so both layers hand out the same IDs
+        assert(a->CreateEntity() == c->CreateEntity());
+    }
+
+    //The entities are spread over the pages and leave some pages unused
+    static void TestPagedSparseArrays()
+    {
+        static_assert(std::is_same_v<SparseArray<PagedCapacity>, PagedSparseArray<PagedCapacity>>);
+
+        std::unique_ptr<EntitySet<PagedCapacity>> set = std::make_unique<EntitySet<PagedCapacity>>();
+        std::unique_ptr<EntitySet<PagedCapacity>> setCopy = std::make_unique<EntitySet<PagedCapacity>>();
+        std::unique_ptr<ComponentCollection<Position, PagedCapacity>> positions = std::make_unique<ComponentCollection<Position, PagedCapacity>>();
+        std::unique_ptr<ComponentCollection<Position, PagedCapacity>> positionsCopy = std::make_unique<ComponentCollection<Position, PagedCapacity>>();
+
+        set->Initialize();
+        setCopy->Initialize();
+        positions->Initialize();
+        positionsCopy->Initialize();
+
+        auto isUsed = [](Entity entity) { return entity % 7 == 0 && (entity < 2048 || entity >= 6144); };
+        auto isErased = [](Entity entity) { return entity % 3 == 0; };
+
+        for (Entity entity = 0; entity < PagedCapacity; ++entity)
+        {
+            if (!isUsed(entity)) continue;
+
+            assert(set->Insert(entity));
+            positions->AddComponent(entity, Position { static_cast<int32_t>(entity), 0 });
+        }
+
+        assert(set->Insert(PagedCapacity - 1));
+        positions->AddComponent(PagedCapacity - 1, Position { -1, -1 });
+
+        for (Entity entity = 0; entity < PagedCapacity; ++entity)
+        {
+            if (!isUsed(entity) || !isErased(entity)) continue;
+
+            set->Erase(entity);
+            positions->RemoveComponent(entity);
+        }
+
+        //A full overwrite into empty copies, then an overwrite that only copies the changed slots
+        setCopy->Overwrite(*set);
+        positionsCopy->Overwrite(positions.get());
+
+        positions->GetComponent(7).Y = 7;
+        positions->RemoveComponent(PagedCapacity - 1);
+        set->Erase(PagedCapacity - 1);
+
+        setCopy->Overwrite(*set);
+        positionsCopy->Overwrite(positions.get());
+
+        for (Entity entity = 0; entity < PagedCapacity; ++entity)
+        {
+            const bool contained = isUsed(entity) && !isErased(entity);
+
+            assert(setCopy->Contains(entity) == contained);
+            assert(positionsCopy->HasComponent(entity) == contained);
+
+            if (!contained) continue;
+
+            const Position& position = std::as_const(*positionsCopy).GetComponent(entity);
+            assert(position.X == static_cast<int32_t>(entity) && position.Y == (entity == 7 ? 7 : 0));
+        }
+
+        assert(setCopy->Size() == set->Size() && positionsCopy->GetEntityCount() == set->Size());
+
+        //Copying a set clears its own entries first
+        *set = *setCopy;
+        set->Erase(7);
+        *setCopy = *set;
+
+        assert(!setCopy->Contains(7) && setCopy->Contains(14) && setCopy->Size() == set->Size());
+    }
+
+    static void TestQueries()
+    {
+        std::unique_ptr<TestSparseSetLayer> layer = std::make_unique<TestSparseSetLayer>();
+        std::unique_ptr<TestSparseSetLayer> other = std::make_unique<TestSparseSetLayer>();
+
+        constexpr Entity count = 10;
+
+        for (Entity entity = 0; entity < count; ++entity)
+        {
+            layer->CreateEntity();
+            layer->AddComponent(entity, Position { });
+            if (entity % 2 == 0) layer->AddComponent(entity, Frozen { });
+        }
+
+        //Created after the entities, so it starts with the matching entities
+        const QueryId moving = layer->CreateQuery<ComponentList<Position>, ComponentList<Frozen>>();
+        const QueryId frozen = layer->CreateQuery<ComponentList<Frozen>>();
+
+        for (Entity entity = 0; entity < count; ++entity)
+        {
+            assert(layer->GetQuery(moving).Contains(entity) == (entity % 2 == 1));
+        }
+
+        //Losing an excluded component or a required component changes the membership
+        layer->RemoveComponent<Frozen>(0);
+        layer->RemoveComponent<Position>(1);
+        layer->AddComponent(3, Frozen { });
+        layer->ImmediatelyDestroyEntity(5);
+
+        assert(layer->GetQuery(moving).Contains(0) && !layer->GetQuery(moving).Contains(1));
+        assert(!layer->GetQuery(moving).Contains(3) && !layer->GetQuery(moving).Contains(5));
+        assert(layer->GetQuery(moving).Size() == 3);
+        assert(layer->GetQuery(frozen).Size() == 5 && !layer->GetQuery(frozen).Contains(0));
+
+        //The queries are rebuilt from the overwritten entities
+        for (Entity entity = 0; entity < 4; ++entity)
+        {
+            other->CreateEntity();
+            other->AddComponent(entity, Position { });
+        }
+
+        other->AddComponent(2, Frozen { });
+        layer->Overwrite(*other);
+
+        assert(layer->GetQuery(moving).Size() == 3 && !layer->GetQuery(moving).Contains(2));
+        assert(layer->GetQuery(frozen).Size() == 1 && layer->GetQuery(frozen).Contains(2));
+
+        layer->Clear();
+        assert(layer->GetQuery(moving).Empty() && layer->GetQuery(frozen).Empty());
+
+        //After the rebuild the query follows the changes again
+        const Entity entity = layer->CreateEntity();
+        layer->AddComponent(entity, Position { });
+        assert(layer->GetQuery(moving).Contains(entity));
+
+        //The ID of a destroyed query is reused by a new query with its own components
+        layer->DestroyQuery(moving);
+        const QueryId reused = layer->CreateQuery<ComponentList<Frozen>, ComponentList<Position>>();
+        assert(reused == moving && layer->GetQuery(reused).Empty());
+
+        layer->AddComponent(layer->CreateEntity(), Frozen { });
+        assert(layer->GetQuery(reused).Size() == 1 && layer->GetQuery(frozen).Size() == 1);
+    }
+
+    static void TestObservers()
+    {
+        std::unique_ptr<TestSparseSetLayer> layer = std::make_unique<TestSparseSetLayer>();
+        std::unique_ptr<TestSparseSetLayer> other = std::make_unique<TestSparseSetLayer>();
+
+        for (Entity entity = 0; entity < 8; ++entity)
+        {
+            layer->CreateEntity();
+            if (entity >= 4) layer->AddComponent(entity, Velocity { });
+        }
+
+        const ComponentObserver<TestCapacity>& observer = layer->Observe<Velocity>();
+        assert(observer.WasReset());
+
+        layer->ClearObservers();
+        assert(!observer.WasReset() && observer.GetAdded().empty() && observer.GetRemoved().empty());
+
+        //Removing a component that was added since the last clear cancels out, the last added entity takes its place
+        layer->AddComponent(0, Velocity { });
+        layer->AddComponent(1, Velocity { });
+        layer->AddComponent(2, Velocity { });
+        layer->RemoveComponent<Velocity>(0);
+
+        assert(observer.GetAdded().size() == 2 && observer.GetAdded()[0] == 2 && observer.GetAdded()[1] == 1);
+        assert(observer.GetRemoved().empty());
+
+        layer->RemoveComponent<Velocity>(1);
+        layer->AddComponent(0, Velocity { });
+        assert(observer.GetAdded().size() == 2 && observer.GetAdded()[0] == 2 && observer.GetAdded()[1] == 0);
+
+        layer->ClearObservers();
+
+        //The destroyed ID is handed out again, so the entity loses the component and the new entity gets it
+        layer->ImmediatelyDestroyEntity(5);
+        const Entity entity = layer->CreateEntity();
+        layer->AddComponent(entity, Velocity { });
+
+        assert(entity == 5);
+        assert(observer.GetRemoved().size() == 1 && observer.GetRemoved()[0] == 5);
+        assert(observer.GetAdded().size() == 1 && observer.GetAdded()[0] == 5);
+
+        //Overwriting replaces the state as a whole, so the lists are dropped
+        layer->Overwrite(*other);
+        assert(observer.WasReset() && observer.GetAdded().empty() && observer.GetRemoved().empty());
+
+        layer->ClearObservers();
+        layer->AddComponent(layer->CreateEntity(), Velocity { });
+        assert(!observer.WasReset() && observer.GetAdded().size() == 1 && observer.GetAdded()[0] == 0);
+    }
+
+    static void TestCommandBuffer()
+    {
+        std::unique_ptr<TestSparseSetLayer> layer = std::make_unique<TestSparseSetLayer>();
+
+        for (int32_t i = 0; i < 4; ++i)
+        {
+            const Entity entity = layer->CreateEntity();
+            layer->AddComponent(entity, Position { i, i });
+        }
+
+        layer->AddComponent(0, Velocity { 1, 1 });
+
+        const QueryId moving = layer->CreateQuery<ComponentList<Position, Velocity>>();
+        CommandBuffer<TestComponents, TestCapacity> commands;
+
+        //The pending entities can be used in the commands of the same buffer
+        const Entity pending = commands.CreateEntity();
+        commands.AddComponent(pending, Position { 100, 0 });
+        commands.AddComponent(pending, Velocity { 2, 2 });
+
+        const Entity pendingDestroyed = commands.CreateEntity();
+        commands.AddComponent(pendingDestroyed, Position { });
+        commands.MarkEntityForDestruction(pendingDestroyed);
+
+        //The removal is applied first, so the component is replaced
+        commands.RemoveComponent<Velocity>(0);
+        commands.AddComponent(0, Velocity { 5, 5 });
+
+        //The destruction is applied last, after the entity got its component
+        commands.AddComponent(1, Velocity { 3, 3 });
+        commands.MarkEntityForDestruction(1);
+
+        assert(pending >= TestCapacity && pendingDestroyed >= TestCapacity && !commands.Empty());
+
+        const EntityHandle handle = layer->GetHandle(1);
+        layer->Apply(commands);
+
+        const Entity created = commands.GetCreatedEntity(pending);
+        const Entity destroyed = commands.GetCreatedEntity(pendingDestroyed);
+
+        assert(created != destroyed && created < TestCapacity && destroyed < TestCapacity);
+        assert(layer->GetComponent<Position>(created).X == 100 && layer->GetComponent<Velocity>(created).X == 2);
+        assert(layer->GetComponent<Velocity>(0).X == 5 && layer->GetComponent<Position>(0).X == 0);
+
+        assert(!layer->IsValid(handle) && !layer->HasComponent<Position>(destroyed));
+        assert(layer->GetEntityCount() == 4 && layer->GetComponentCollection<Velocity>()->GetEntityCount() == 2);
+
+        const EntitySet<TestCapacity>& query = layer->GetQuery(moving);
+        assert(query.Size() == 2 && query.Contains(0) && query.Contains(created));
+
+        //The applied buffer is empty and starts over with the next command
+        assert(commands.Empty());
+        assert(commands.CreateEntity() == pending);
+    }
+
+    //Instantiating many entities at once fills the freed IDs first and gives every entity the components of the prefab
+    static void TestInstantiate()
+    {
+        std::unique_ptr<TestSystemLayer> layer = std::make_unique<TestSystemLayer>();
+
+        for (int32_t i = 0; i < 3; ++i)
+        {
+            layer->AddComponent(layer->CreateEntity(), Position { });
+        }
+
+        layer->ImmediatelyDestroyEntity(1);
+
+        Prefab<TestComponents> prefab;
+        prefab.Set(Position { 3, 4 }).Set(Velocity { 1, 0 });
+
+        std::vector<Entity> entities;
+        layer->Instantiate(prefab, 5, entities);
+
+        assert(entities.size() == 5 && entities[0] == 1);
+
+        for (const Entity entity : entities)
+        {
+            assert(layer->GetSignature(entity) == prefab.GetSignature());
+            assert(layer->GetSystem<MovementSystem>()->Entities.Contains(entity));
+
+            const Position& position = layer->GetComponent<Position>(entity);
+            const Velocity& velocity = layer->GetComponent<Velocity>(entity);
+            assert(position.X == 3 && position.Y == 4 && velocity.X == 1 && velocity.Y == 0);
+        }
+
+        //Excluded by the system through the tag of the prefab
+        prefab.Set(Frozen { });
+        prefab.Get<Position>().X = 10;
+
+        std::vector<Entity> frozenEntities;
+        layer->Instantiate(prefab, 3, frozenEntities);
+
+        for (const Entity entity : frozenEntities)
+        {
+            assert(layer->HasComponent<Frozen>(entity) && layer->GetComponent<Position>(entity).X == 10);
+            assert(!layer->GetSystem<MovementSystem>()->Entities.Contains(entity));
+        }
+
+        assert(layer->GetEntityCount() == 10 && layer->GetSystem<MovementSystem>()->Entities.Size() == 5);
+        assert(layer->GetComponentCollection<Position>()->GetEntityCount() == 10);
+        assert(layer->GetComponentCollection<Velocity>()->GetEntityCount() == 8);
+
+        //Removing the tag from the prefab does not change the entities that were already created
+        prefab.Remove<Frozen>();
+        const Entity entity = layer->Instantiate(prefab);
+
+        assert(layer->GetSystem<MovementSystem>()->Entities.Contains(entity) && layer->HasComponent<Frozen>(frozenEntities[0]));
+    }
+};
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Work-stealing thread pool. Every worker has its own queue and takes the newest task of its own queue first.
+//When its queue is empty it steals the oldest task of another queue. Threads that are not part of the pool share one extra queue
+//A thread that waits for tasks can help with RunPendingTask, so waiting never blocks a worker
+class ThreadPool
+{
+    using Task = std::function<void()>;
+
+    struct WorkQueue
+    {
+        std::mutex Mutex;
+        std::deque<Task> Tasks;
+    };
+
+public:
+    explicit ThreadPool(uint32_t threadCount = std::max(1u, std::thread::hardware_concurrency())) : pendingCount(0), stopping(false)
+    {
+        //The last queue is used by the threads outside of the pool
+        for (uint32_t i = 0; i <= threadCount; ++i)
+        {
+            queues.push_back(std::make_unique<WorkQueue>());
+        }
+
+        for (uint32_t i = 0; i < threadCount; ++i)
+        {
+            threads.emplace_back([this, i] { WorkerLoop(i); });
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lock(sleepMutex);
+            stopping = true;
+        }
+
+        wake.notify_all();
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    //Adds the task to the queue of the calling thread
+    //The pending count is increased before the queue is unlocked, so a thread that takes the task can never decrease it first
+    void Submit(Task task)
+    {
+        WorkQueue& queue = *queues[GetQueueIndex()];
+
+        {
+            std::lock_guard lock(queue.Mutex);
+            queue.Tasks.push_back(std::move(task));
+
+            std::lock_guard sleepLock(sleepMutex);
+            pendingCount++;
+        }
+
+        wake.notify_one();
+    }
+
+    //Runs one pending task on the calling thread. Returns false when no task was pending
+    bool RunPendingTask()
+    {
+        Task task;
+
+        if (!TryTake(GetQueueIndex(), task)) return false;
+
+        task();
+        return true;
+    }
+
+    //Splits [0, count) into chunks of chunkSize and calls func(begin, end) for each chunk on the pool. Returns when all chunks are done
+    //The chunk boundaries only depend on the count and the chunk size. The calling thread runs the first chunk and helps with the others
+    template<typename Func>
+    void ParallelFor(uint32_t count, uint32_t chunkSize, Func&& func)
+    {
+        assert(chunkSize > 0 && "Chunk size needs to be larger than 0");
+
+        const uint32_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+        if (chunkCount <= 1)
+        {
+            if (count > 0) func(0u, count);
+            return;
+        }
+
+        std::atomic<uint32_t> unfinishedCount = chunkCount;
+
+        for (uint32_t chunk = 1; chunk < chunkCount; ++chunk)
+        {
+            Submit([&, chunk]
+            {
+                func(chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize));
+                unfinishedCount--;
+            });
+        }
+
+        func(0u, chunkSize);
+        unfinishedCount--;
+
+        while (unfinishedCount > 0)
+        {
+            if (!RunPendingTask())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    uint32_t GetThreadCount() const
+    {
+        return static_cast<uint32_t>(threads.size());
+    }
+
+private:
+    void WorkerLoop(uint32_t index)
+    {
+        workerIndex = index;
+        workerPool = this;
+
+        while (true)
+        {
+            Task task;
+
+            if (TryTake(index, task))
+            {
+                task();
+                continue;
+            }
+
+            std::unique_lock lock(sleepMutex);
+            wake.wait(lock, [this] { return stopping || pendingCount > 0; });
+
+            if (stopping) return;
+        }
+    }
+
+    //Takes the newest task of the own queue, or steals the oldest task of another queue
+    bool TryTake(uint32_t index, Task& task)
+    {
+        const uint32_t queueCount = static_cast<uint32_t>(queues.size());
+
+        for (uint32_t i = 0; i < queueCount; ++i)
+        {
+            WorkQueue& queue = *queues[(index + i) % queueCount];
+            std::lock_guard lock(queue.Mutex);
+
+            if (queue.Tasks.empty()) continue;
+
+            if (i == 0)
+            {
+                task = std::move(queue.Tasks.back());
+                queue.Tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.Tasks.front());
+                queue.Tasks.pop_front();
+            }
+
+            std::lock_guard sleepLock(sleepMutex);
+            pendingCount--;
+            return true;
+        }
+
+        return false;
+    }
+
+    inline uint32_t GetQueueIndex() const
+    {
+        return workerPool == this ? workerIndex : static_cast<uint32_t>(threads.size());
+    }
+
+private:
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    uint32_t pendingCount;
+    bool stopping;
+
+    inline static thread_local uint32_t workerIndex = 0;
+    inline static thread_local const ThreadPool* workerPool = nullptr;
+};
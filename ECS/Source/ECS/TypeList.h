@@ -16,9 +16,21 @@ struct Count<TypeList<Ts...>>
 template<typename List>
 constexpr std::size_t Count_v = Count<List>::value;
 
-//Total size (bytes)
+//Rounds the offset up to the alignment of T
+template<typename T>
+constexpr std::size_t AlignOffset(std::size_t offset)
+{
+    return (offset + alignof(T) - 1) / alignof(T) * alignof(T);
+}
+
+//Total size (bytes) when the types are placed after each other at their alignment
 template<typename... Ts>
-constexpr size_t TotalSize_v = (sizeof(Ts) + ... + 0);
+constexpr size_t TotalSize_v = []
+{
+    std::size_t size = 0;
+    ((size = AlignOffset<Ts>(size) + sizeof(Ts)), ...);
+    return size;
+}();
 
 //IndexOf
 template<typename T, typename List>
@@ -55,7 +67,7 @@ struct Contains<T, TypeList<U, Ts...>> : Contains<T, TypeList<Ts...>> { };
 template<typename T, typename List>
 constexpr bool Contains_v = Contains<T, List>::value;
 
-//GetOffsets
+//GetOffsets, every offset is aligned for its type when the storage starts at the largest alignment
 template<typename... Ts>
 constexpr auto GetOffsets()
 {
@@ -63,7 +75,7 @@ constexpr auto GetOffsets()
 
     std::size_t offset = 0;
     std::size_t i = 0;
-    ((result[i++] = offset, offset += sizeof(Ts)), ...);
+    ((offset = AlignOffset<Ts>(offset), result[i++] = offset, offset += sizeof(Ts)), ...);
 
     return result;
 }
\ No newline at end of file
@@ -4,21 +4,25 @@
 #include "../ECS/ECSSettings.h"
 #include "../ECS/ECS.h"
 
+#include <utility>
+
 class WorldManager
 {
 public:
     WorldManager() :
         BaseLayer(PhysicsLayer()), ConfirmedLayer(PhysicsLayer()),
-        BasePhysicsWorldData(1, 12), ConfirmedPhysicsWorldData(1, 0),
-        BasePhysicsWorld(BaseLayer, BasePhysicsWorldData) { }
+        BasePhysicsWorld(BaseLayer, 1, 12)
+    {
+        //Start with the empty layer as confirmed state
+        ConfirmedLayer.Overwrite(BaseLayer);
+    }
 
     void NextFrame(FrameNumber confirmedFrame)
     {
         if (BasePhysicsWorld.GetCurrentFrame() == confirmedFrame)
         {
-            //Save confirmed game state
+            //Save confirmed game state, the resources are part of the layer
             ConfirmedLayer.Overwrite(BaseLayer);
-            ConfirmedPhysicsWorldData = BasePhysicsWorldData;
         }
     }
 
@@ -26,19 +30,18 @@ public:
     int32_t Restore()
     {
         FrameNumber currentFrame = BasePhysicsWorld.GetCurrentFrame();
+        FrameNumber confirmedFrame = std::as_const(ConfirmedLayer).GetResource<WorldFrame>().Number;
 
-        if (currentFrame <= ConfirmedPhysicsWorldData.CurrentFrame) return currentFrame - ConfirmedPhysicsWorldData.CurrentFrame;
+        if (currentFrame <= confirmedFrame) return currentFrame - confirmedFrame;
 
         //Restore last confirmed game state
         BaseLayer.Overwrite(ConfirmedLayer);
-        BasePhysicsWorldData = ConfirmedPhysicsWorldData; //todo check if same LastConfirmedFrame
-        return currentFrame - ConfirmedPhysicsWorldData.CurrentFrame;
+        return currentFrame - confirmedFrame;
     }
 
     void Reset()
     {
         ConfirmedLayer.Overwrite(BaseLayer);
-        ConfirmedPhysicsWorldData = BasePhysicsWorldData;
     }
 
     PhysicsWorld& GetPhysicsWorld()
@@ -49,7 +52,5 @@ public:
 private:
     PhysicsLayer BaseLayer;                    //Layer that gets updated
     PhysicsLayer ConfirmedLayer;               //Layer of the last confirmed frame, which is only used to save to and restore from
-    PhysicsWorldData BasePhysicsWorldData;
-    PhysicsWorldData ConfirmedPhysicsWorldData;
     PhysicsWorld BasePhysicsWorld;  //todo reorder
 };
\ No newline at end of file
@@ -9,22 +9,35 @@
 #include "../../Rendering/Camera.h"
 #include "../../Physics/Physics.h"
 #include "../Input/Input.h"
-#include "PhysicsWorldData.h"
 
 #include <vector>
 #include <array>
+#include <bitset>
+#include <memory>
 #include <random>
+#include <stdexcept>
+#include <utility>
 
 class PhysicsWorld : public World
 {
 public:
-    explicit PhysicsWorld(PhysicsLayer& player, PhysicsWorldData& pPhysicsWorldData) : baseLayer(player), physicsWorldData(pPhysicsWorldData)
+    explicit PhysicsWorld(PhysicsLayer& player, FrameNumber startFrame, uint32_t seed) : baseLayer(player), scheduler(threadPool)
     {
+        SetupResources(player, startFrame, seed);
         SetupComponents(player);
         SetupSystems(player);
+        SetupSchedule();
         InitializeCamera();
     }
 
+    ///Sets the start state of the resources of the layer
+    void SetupResources(PhysicsLayer& layer, FrameNumber startFrame, uint32_t seed)
+    {
+        layer.SetResource(WorldFrame { startFrame });
+        layer.SetResource(WorldRandom { std::mt19937(seed) });
+        layer.GetResource<PhysicsCache>().Initialize();
+    }
+
     ///Registers all components to the layer, sets the component collections and creates a signature which includes all components
     void SetupComponents(PhysicsLayer& layer) //TODO: use GetSystem()
     {
@@ -47,20 +60,70 @@ public:
         includedComponents.set(PhysicsComponentManager::GetComponentType<PolygonCollider>(), true);
         includedComponents.set(PhysicsComponentManager::GetComponentType<ColliderRenderData>(), true);
         includedComponents.set(PhysicsComponentManager::GetComponentType<Movable>(), true);
+        includedComponents.set(PhysicsComponentManager::GetComponentType<StaticBody>(), true);
     }
 
     void SetupSystems(PhysicsLayer& layer)
     {
         rigidBodySystem = layer.GetSystem<RigidBody>();
+        integrationSystem = layer.GetSystem<IntegrationSystem>();
         circleColliderRenderer = layer.GetSystem<CircleColliderRenderer>();
         boxColliderRenderer = layer.GetSystem<BoxColliderRenderer>();
         polygonColliderRenderer = layer.GetSystem<PolygonColliderRenderer>();
         movingSystem = layer.GetSystem<MovingSystem>();
     }
 
+    ///Adds the update steps of the systems to the scheduler in their serial order. Steps that do not share written components can run at the same time
+    ///All physics steps write Transform, so the scheduler runs them as a chain on the calling thread and only the views inside the steps use the pool
+    ///The collider renderers are not scheduled, they issue OpenGL calls and have to stay on the render thread
+    void SetupSchedule()
+    {
+        scheduler.Add<MovingSystem>([this]
+        {
+            movingSystem->Update(frameDeltaTime, frameInput->GetKey(GLFW_KEY_W), frameInput->GetKey(GLFW_KEY_S), frameInput->GetKey(GLFW_KEY_A), frameInput->GetKey(GLFW_KEY_D), frameInput->GetKey(GLFW_KEY_Q), frameInput->GetKey(GLFW_KEY_E), threadPool);
+        });
+
+        scheduler.Add<RigidBody>([this]
+        {
+            //The rigid body system writes the impulse cache through its pointer
+            baseLayer.MarkResourceChanged<PhysicsCache>();
+            rigidBodySystem->HandleCollisions(GetCurrentFrame(), baseLayer.GetGenerations());
+        });
+
+        scheduler.Add<IntegrationSystem>([this]
+        {
+            integrationSystem->IntegrateForces(frameDeltaTime, threadPool);
+        });
+
+        scheduler.Add<RigidBody>([this]
+        {
+            rigidBodySystem->SetupContacts();
+
+            for (uint8_t i = 0; i < PhysicsIterations; ++i)
+            {
+                rigidBodySystem->SolveContacts();
+            }
+        });
+
+        scheduler.Add<IntegrationSystem>([this]
+        {
+            integrationSystem->IntegrateVelocities(frameDeltaTime, threadPool);
+        });
+
+        scheduler.Add<RigidBody>([this]
+        {
+            rigidBodySystem->IntegratePositions();
+        });
+
+        scheduler.Add<IntegrationSystem>([this]
+        {
+            integrationSystem->SortBodies(SortSwapsPerFrame);
+        });
+    }
+
     void InitializeCache(CacheManager* cache)
     {
-        rigidBodySystem->InitializeCache(cache->GetCollisionCache(), &physicsWorldData.Cache);
+        rigidBodySystem->InitializeCache(cache->GetCollisionCache(), &baseLayer.GetResource<PhysicsCache>());
     }
 
     void InitializeCamera()
@@ -86,7 +149,7 @@ public:
 
         for (int i = 0; i < 15; ++i)
         {
-            PhysicsUtils::CreateRandomCircle(baseLayer, physicsWorldData.NumberGenerator, camera.Left, camera.Right, camera.Bottom, camera.Top);
+            PhysicsUtils::CreateRandomCircle(baseLayer, baseLayer.GetResource<WorldRandom>().Generator, camera.Left, camera.Right, camera.Bottom, camera.Top);
         }
 
         baseLayer.AddComponent(10, Movable(Fixed16_16(20)));
@@ -94,12 +157,12 @@ public:
         //Add boxes/
         for (int i = 0; i < 15; ++i)
         {
-            PhysicsUtils::CreateRandomBox(baseLayer, physicsWorldData.NumberGenerator, camera.Left, camera.Right, camera.Bottom, camera.Top);
+            PhysicsUtils::CreateRandomBox(baseLayer, baseLayer.GetResource<WorldRandom>().Generator, camera.Left, camera.Right, camera.Bottom, camera.Top);
         }
 
         for (int i = 0; i < 15; ++i)
         {
-            PhysicsUtils::CreateRandomPolygon(baseLayer, physicsWorldData.NumberGenerator, camera.Left, camera.Right, camera.Bottom, camera.Top);
+            PhysicsUtils::CreateRandomPolygon(baseLayer, baseLayer.GetResource<WorldRandom>().Generator, camera.Left, camera.Right, camera.Bottom, camera.Top);
         }
     }
 
@@ -118,22 +181,11 @@ public:
     {
         UpdateDebug(inputs);
 
-        Input* playerInput = inputs[0];
-        movingSystem->Update(deltaTime, playerInput->GetKey(GLFW_KEY_W), playerInput->GetKey(GLFW_KEY_S), playerInput->GetKey(GLFW_KEY_A), playerInput->GetKey(GLFW_KEY_D), playerInput->GetKey(GLFW_KEY_Q), playerInput->GetKey(GLFW_KEY_E));
-
-        rigidBodySystem->HandleCollisions(physicsWorldData.CurrentFrame);
-        rigidBodySystem->IntegrateForces(deltaTime);
-        rigidBodySystem->SetupContacts();
-
-        for (uint8_t i = 0; i < PhysicsIterations; ++i)
-        {
-            rigidBodySystem->SolveContacts();
-        }
-
-        rigidBodySystem->IntegrateVelocities(deltaTime);
-        rigidBodySystem->IntegratePositions();
+        frameDeltaTime = deltaTime;
+        frameInput = inputs[0];
+        scheduler.Run();
 
-        ++physicsWorldData.CurrentFrame;
+        ++baseLayer.GetResource<WorldFrame>().Number;
     }
 
     void UpdateDebug(std::vector<Input*>& inputs)
@@ -142,19 +194,19 @@ public:
         {
             if (input->GetKeyDown(GLFW_MOUSE_BUTTON_LEFT))
             {
-                PhysicsUtils::CreateRandomCircleFromPosition(baseLayer, physicsWorldData.NumberGenerator, input->GetMousePosition(camera));
+                PhysicsUtils::CreateRandomCircleFromPosition(baseLayer, baseLayer.GetResource<WorldRandom>().Generator, input->GetMousePosition(camera));
                 std::cout << "Create new circle\n";
             }
 
             if (input->GetKeyDown(GLFW_MOUSE_BUTTON_RIGHT))
             {
-                PhysicsUtils::CreateRandomBoxFromPosition(baseLayer, physicsWorldData.NumberGenerator, input->GetMousePosition(camera));
+                PhysicsUtils::CreateRandomBoxFromPosition(baseLayer, baseLayer.GetResource<WorldRandom>().Generator, input->GetMousePosition(camera));
                 std::cout << "Create new box\n";
             }
 
             if (input->GetKeyDown(GLFW_MOUSE_BUTTON_MIDDLE))
             {
-                PhysicsUtils::CreateRandomPolygonFromPosition(baseLayer, physicsWorldData.NumberGenerator, input->GetMousePosition(camera));
+                PhysicsUtils::CreateRandomPolygonFromPosition(baseLayer, baseLayer.GetResource<WorldRandom>().Generator, input->GetMousePosition(camera));
                 std::cout << "Create new convex\n";
             }
         }
@@ -181,12 +233,12 @@ public:
 
     inline FrameNumber GetCurrentFrame() const
     {
-        return physicsWorldData.CurrentFrame;
+        return std::as_const(baseLayer).GetResource<WorldFrame>().Number;
     }
 
     inline std::mt19937 GetNumberGenerator() const
     {
-        return physicsWorldData.NumberGenerator;
+        return std::as_const(baseLayer).GetResource<WorldRandom>().Generator;
     }
 
     //Serialization
@@ -203,14 +255,15 @@ public:
 
     void Serialize(Stream& stream) const
     {
-        std::vector<Entity> entities;
-        std::vector<PhysicsSignature> signatures;
+        //Reuse the vectors of the last serialization to avoid allocating every frame
+        std::vector<Entity>& entities = serializedEntities;
+        std::vector<PhysicsSignature>& signatures = serializedSignatures;
 
         //Write current frame
-        stream.WriteInteger<FrameNumber>(physicsWorldData.CurrentFrame);
+        stream.WriteInteger<FrameNumber>(GetCurrentFrame());
 
         //Write number generator
-        SerializeGenerator(stream, physicsWorldData.NumberGenerator);
+        SerializeGenerator(stream, std::as_const(baseLayer).GetResource<WorldRandom>().Generator);
 
         //Write the signatures of all active entities
         SerializeEntities(stream, entities, signatures);
@@ -232,37 +285,50 @@ public:
     ///Deserializes the stream and overwrites the layer data. Only use this methode in a try loop
     void Deserialize(Stream& stream)
     {
-        //Create a new layer and then Overwrite the existing layer with the new layer
-        PhysicsLayer physicsLayer = PhysicsLayer();
-        //physicsLayer.CreateEntity(); //Create an entity that would be the camera - essential for maintaining a correct entity queue //TODO pot issue
+        //Fill the cleared scratch layer and then Overwrite the existing layer with it. The scratch layer is only allocated once
+        if (!deserializeLayer)
+        {
+            deserializeLayer = std::make_unique<PhysicsLayer>();
+        }
+
+        PhysicsLayer& physicsLayer = *deserializeLayer;
+        physicsLayer.Clear();
 
         std::vector<Entity> entities;
         std::vector<PhysicsSignature> signatures;
-        std::array<uint32_t, MAXENTITIES> entityIndexes;
+        std::array<uint32_t, MaxPhysicsEntities> entityIndexes;
+        std::bitset<MaxPhysicsEntities> entityPresent;
 
-        physicsWorldData.CurrentFrame = stream.ReadInteger<FrameNumber>();
+        physicsLayer.GetResource<WorldFrame>().Number = stream.ReadInteger<FrameNumber>();
 
         //Read the number generator
-        DeserializeGenerator(stream, physicsWorldData.NumberGenerator);
+        DeserializeGenerator(stream, physicsLayer.GetResource<WorldRandom>().Generator);
 
         //Read the signatures of all active entities
         DeserializeEntities(stream, entities, signatures);
 
-        AddEntities(physicsLayer, entities, entityIndexes);
-        physicsLayer.IgnoreSignatureChanged(true);
+        AddEntities(physicsLayer, entities, entityPresent, entityIndexes);
 
-        //Write all component data
-        DeserializeComponentCollection<Transform>(stream, physicsLayer, entityIndexes, signatures);
-        DeserializeComponentCollection<TransformMeta>(stream, physicsLayer, entityIndexes, signatures);
-        DeserializeComponentCollection<RigidBodyData>(stream, physicsLayer, entityIndexes, signatures);
-        DeserializeComponentCollection<CircleCollider>(stream, physicsLayer, entityIndexes, signatures);
-        DeserializeComponentCollection<BoxCollider>(stream, physicsLayer, entityIndexes, signatures);
-        DeserializeComponentCollection<PolygonCollider>(stream, physicsLayer, entityIndexes, signatures);
-        DeserializeComponentCollection<ColliderRenderData>(stream, physicsLayer, entityIndexes, signatures);
-        DeserializeComponentCollection<Movable>(stream, physicsLayer, entityIndexes, signatures);
-
-        //Add the entities to the systems
-        AddEntitiesToSystems(physicsLayer, entities, signatures);
+        //Record all component data and add it in one batch, so each entity only enters its systems once
+        PhysicsCommandBuffer commands;
+        DeserializeComponentCollection<Transform>(stream, commands, entityPresent, entityIndexes, signatures);
+        DeserializeComponentCollection<TransformMeta>(stream, commands, entityPresent, entityIndexes, signatures);
+        DeserializeComponentCollection<RigidBodyData>(stream, commands, entityPresent, entityIndexes, signatures);
+        DeserializeComponentCollection<CircleCollider>(stream, commands, entityPresent, entityIndexes, signatures);
+        DeserializeComponentCollection<BoxCollider>(stream, commands, entityPresent, entityIndexes, signatures);
+        DeserializeComponentCollection<PolygonCollider>(stream, commands, entityPresent, entityIndexes, signatures);
+        DeserializeComponentCollection<ColliderRenderData>(stream, commands, entityPresent, entityIndexes, signatures);
+        DeserializeComponentCollection<Movable>(stream, commands, entityPresent, entityIndexes, signatures);
+
+        //Tags are only part of the signatures
+        DeserializeTag<StaticBody>(commands, entities, signatures);
+
+        //Add the components and add the entities to the systems
+        physicsLayer.Apply(commands);
+        VerifySignatures(physicsLayer, entities, signatures);
+
+        //The impulse cache is not part of the stream, so the cache of the base layer is kept
+        physicsLayer.SetResource(std::as_const(baseLayer).GetResource<PhysicsCache>());
 
         //Overwrite the layer with the new layer that holds the received data
         baseLayer.Overwrite(physicsLayer);
@@ -324,7 +390,7 @@ private:
     }
 
     template<typename Component>
-    static void SerializeComponentCollection(Stream& stream, ComponentCollection<Component>* componentCollection, const std::vector<Entity>& entities, const std::vector<PhysicsSignature>& signatures)
+    static void SerializeComponentCollection(Stream& stream, PhysicsComponentCollection<Component>* componentCollection, const std::vector<Entity>& entities, const std::vector<PhysicsSignature>& signatures)
     {
         //Write the componentType
         ComponentType componentType = PhysicsComponentManager::GetComponentType<Component>();
@@ -353,9 +419,9 @@ private:
         //Read the entity count
         Entity entityCount = stream.ReadInteger<Entity>();
 
-        if (entityCount > MAXENTITIES)
+        if (entityCount > MaxPhysicsEntities)
         {
-            throw "Entity count larger than MAXENTITIES";
+            throw std::out_of_range("Entity count larger than MaxPhysicsEntities");
         }
 
         entities.resize(entityCount);
@@ -375,84 +441,97 @@ private:
         iss >> generator;
     }
 
-    //Add entities to the layer
-    static void AddEntities(PhysicsLayer& physicsLayer, const std::vector<Entity>& entities, std::array<uint32_t, MAXENTITIES>& entityIndexes)
+    //Add entities to the empty layer with the received entity IDs
+    static void AddEntities(PhysicsLayer& physicsLayer, const std::vector<Entity>& entities, std::bitset<MaxPhysicsEntities>& entityPresent, std::array<uint32_t, MaxPhysicsEntities>& entityIndexes)
     {
-        for (Entity entity = 0; entity < MAXENTITIES; ++entity)
+        for (uint32_t i = 0; i < entities.size(); ++i)
         {
-            physicsLayer.CreateEntity();
-        }
+            Entity entity = entities[i];
 
-        std::bitset<MAXENTITIES> entityPresent;
+            if (entity >= MaxPhysicsEntities || entityPresent.test(entity))
+            {
+                throw std::out_of_range("Entity out of range or received twice");
+            }
 
-        for (const Entity& entity : entities)
-        {
             entityPresent.set(entity, true);
-        }
-
-        for (Entity entity = 0; entity < MAXENTITIES; ++entity)
-        {
-            if (!entityPresent.test(entity))
-                physicsLayer.ImmediatelyDestroyEntity(entity);
-        }
+            physicsLayer.CreateEntity(entity);
 
-        //Create a list with the entity indexes
-        for (uint32_t i = 0; i < entities.size(); ++i)
-        {
-            entityIndexes[entities[i]] = i;
+            //Create a list with the entity indexes
+            entityIndexes[entity] = i;
         }
     }
 
     template<typename Component>
-    static void DeserializeComponentCollection(Stream& stream, PhysicsLayer& physicsLayer, std::array<uint32_t, MAXENTITIES>& entityIndexes, const std::vector<PhysicsSignature>& signatures)
+    static void DeserializeComponentCollection(Stream& stream, PhysicsCommandBuffer& commands, const std::bitset<MaxPhysicsEntities>& entityPresent, const std::array<uint32_t, MaxPhysicsEntities>& entityIndexes, const std::vector<PhysicsSignature>& signatures)
     {
         //Read the componentType and verify
         ComponentType componentType = stream.ReadInteger<ComponentType>();
-        PhysicsSignature componentSignature = 0;
-        componentSignature.set(componentType, true);
 
         if (componentType != PhysicsComponentManager::GetComponentType<Component>())
         {
-            throw "Component type mismatch";
+            throw std::out_of_range("Component type mismatch");
         }
 
+        PhysicsSignature componentSignature = 0;
+        componentSignature.set(componentType, true);
+
         //Read the entity count of the component collection
         uint32_t entityCount = stream.ReadInteger<uint32_t>();
-        uint32_t signaturesCount = signatures.size();
 
-        ComponentCollection<Component>* componentCollection = physicsLayer.GetComponentCollection<Component>();
+        if (entityCount > signatures.size())
+        {
+            throw std::out_of_range("Entity out of range of signatures");
+        }
+
+        //The commands are only applied after all collections are read, so an entity that is received twice needs to be rejected here
+        std::bitset<MaxPhysicsEntities> entityReceived;
 
         //Read the entity and the component Data
-        for (int i = 0; i < entityCount; ++i)
+        for (uint32_t i = 0; i < entityCount; ++i)
         {
             Entity entity = stream.ReadInteger<Entity>();
 
-            if (entityCount > signaturesCount)
+            if (entity >= MaxPhysicsEntities || !entityPresent.test(entity) || entityReceived.test(entity))
             {
-                throw "Entity out of range of signatures";
+                throw std::out_of_range("Component of an entity that was not received or received twice");
             }
 
             if ((signatures[entityIndexes[entity]] & componentSignature).none())
             {
-                throw "Signature does not match component type";
+                throw std::out_of_range("Signature does not match component type");
             }
 
+            entityReceived.set(entity, true);
+
             //Create new component from the stream using the specified constructor
-            physicsLayer.AddComponent(entity, Component(stream)); //TODO: IMPORTANT FOR DESER: FIRST DID HAVE A CALL TO COMPONENT MANAGER WITHOUT CALL TO LAYER SO NOW DOING STUFF IT SHOULD NOT DO
+            commands.AddComponent(entity, Component(stream));
         }
     }
 
-    ///Adds the entities to the systems
-    static void AddEntitiesToSystems(PhysicsLayer& physicsLayer, const std::vector<Entity>& entities, const std::vector<PhysicsSignature>& signatures)
+    ///Adds the tag to every entity that has the tag in its received signature
+    template<typename Tag>
+    static void DeserializeTag(PhysicsCommandBuffer& commands, const std::vector<Entity>& entities, const std::vector<PhysicsSignature>& signatures)
     {
+        ComponentType componentType = PhysicsComponentManager::GetComponentType<Tag>();
+
         for (uint32_t i = 0; i < entities.size(); ++i)
         {
-            if (physicsLayer.GetSignature(entities[i]) != signatures[i])
+            if (signatures[i].test(componentType))
             {
-                throw "The received signature does not match the signature from the registered components";
+                commands.AddComponent(entities[i], Tag());
             }
+        }
+    }
 
-            physicsLayer.FinalizeEntitySystems(entities[i]);
+    ///Verifies that the signatures of the added components match the received signatures
+    static void VerifySignatures(PhysicsLayer& physicsLayer, const std::vector<Entity>& entities, const std::vector<PhysicsSignature>& signatures)
+    {
+        for (uint32_t i = 0; i < entities.size(); ++i)
+        {
+            if (physicsLayer.GetSignature(entities[i]) != signatures[i])
+            {
+                throw std::out_of_range("The received signature does not match the signature from the registered components");
+            }
         }
     }
 
@@ -489,26 +568,37 @@ private:
 
 private:
     PhysicsLayer& baseLayer;
-    PhysicsWorldData& physicsWorldData;
 
     //Systems
     RigidBody* rigidBodySystem;
+    IntegrationSystem* integrationSystem;
     CircleColliderRenderer* circleColliderRenderer;
     BoxColliderRenderer* boxColliderRenderer;
     PolygonColliderRenderer* polygonColliderRenderer;
     MovingSystem* movingSystem;
 
+    //Scratch layer that the received state is deserialized into
+    std::unique_ptr<PhysicsLayer> deserializeLayer;
+
+    //Scheduling
+    ThreadPool threadPool;
+    PhysicsScheduler scheduler;
+    Fixed16_16 frameDeltaTime;
+    Input* frameInput = nullptr;
+
     //Components
-    ComponentCollection<Transform>* transformCollection;
-    ComponentCollection<TransformMeta>* transformMetaCollection;
-    ComponentCollection<RigidBodyData>* rigidBodyDataCollection;
-    ComponentCollection<CircleCollider>* circleColliderCollection;
-    ComponentCollection<BoxCollider>* boxColliderCollection;
-    ComponentCollection<PolygonCollider>* polygonColliderCollection;
-    ComponentCollection<ColliderRenderData>* colliderRenderDataCollection;
-    ComponentCollection<Movable>* movableCollection;
+    PhysicsComponentCollection<Transform>* transformCollection;
+    PhysicsComponentCollection<TransformMeta>* transformMetaCollection;
+    PhysicsComponentCollection<RigidBodyData>* rigidBodyDataCollection;
+    PhysicsComponentCollection<CircleCollider>* circleColliderCollection;
+    PhysicsComponentCollection<BoxCollider>* boxColliderCollection;
+    PhysicsComponentCollection<PolygonCollider>* polygonColliderCollection;
+    PhysicsComponentCollection<ColliderRenderData>* colliderRenderDataCollection;
+    PhysicsComponentCollection<Movable>* movableCollection;
 
     PhysicsSignature includedComponents;
+    mutable std::vector<Entity> serializedEntities;
+    mutable std::vector<PhysicsSignature> serializedSignatures;
 
     Camera camera;
 };
\ No newline at end of file
@@ -11,7 +11,6 @@
 using Cell = std::uint32_t;
 static constexpr std::uint32_t MainBufferSize = 64;
 static constexpr std::uint32_t ExtraBufferSize = 32;
-static constexpr std::uint32_t ExtraBufferCount = MAXENTITIES / ExtraBufferSize;
 
 static constexpr Rect PartitionArea = Rect(Vector2(0, 0), Vector2(SCREEN_WIDTH, SCREEN_HEIGHT));
 static constexpr Fixed16_16 MaxEntitySize = Fixed16_16::FromFixed(50, 0);
@@ -20,9 +19,7 @@ static constexpr Fixed16_16 CellSize = MaxEntitySize;
 static constexpr Cell CellCountX = static_cast<Cell>(fpm::ceilInt(PartitionArea.Size.X / CellSize));
 static constexpr Cell CellCountY = static_cast<Cell>(fpm::ceilInt(PartitionArea.Size.Y / CellSize));
 static constexpr Cell CellCount = CellCountX * CellCountY;
-static constexpr std::uint32_t IndexNull = MAXENTITIES + 1;
 static constexpr std::uint32_t CellNull = CellCount + 1;
-static constexpr std::uint32_t SecondaryIndexNull = ExtraBufferCount + 1;
 static constexpr Vector2uI CellOffsets[4] =
 {
     Vector2uI(0, 0),  //Self
@@ -49,8 +46,14 @@ struct EntityPair2
     }
 };
 
+//The capacity is the entity capacity of the layer that uses the grid
+template<uint32_t Capacity = MAXENTITIES>
 struct PartitionGrid2 //assuming that all entities have the same size (or the given size is the max size) and no position is out of bounds
 {
+    static constexpr std::uint32_t ExtraBufferCount = Capacity / ExtraBufferSize;
+    static constexpr std::uint32_t IndexNull = Capacity + 1;
+    static constexpr std::uint32_t SecondaryIndexNull = ExtraBufferCount + 1;
+
     PartitionGrid2()
     {
         extraBufferIndex.fill(IndexNull);
@@ -85,7 +88,7 @@ struct PartitionGrid2 //assuming that all entities have the same size (or the gi
 
     void InsertEntity(Entity entity, Cell cell)
     {
-        assert(entity < MAXENTITIES && "Could not insert entity - entity above entity limit");
+        assert(entity < Capacity && "Could not insert entity - entity above entity limit");
         assert(cell < CellCount && "Could not insert entity - cell above cell limit");
 
         if (entityCount[cell] < MainBufferSize)
@@ -181,7 +184,7 @@ struct PartitionGrid2 //assuming that all entities have the same size (or the gi
     [[nodiscard]] std::vector<EntityPair2> GetEntityPairs() const
     {
         std::vector<EntityPair2> entityPairs;
-        entityPairs.reserve(MAXENTITIES * 5);
+        entityPairs.reserve(Capacity * 5);
 
         for(Cell cellX = 0; cellX < CellCountX; ++cellX)
         {
@@ -304,8 +307,8 @@ struct PartitionGrid2 //assuming that all entities have the same size (or the gi
 
 private:
     std::array<Rect, CellCount> cellAreas { };
-    std::array<uint32_t, MAXENTITIES> entityIndexes { };
-    std::array<Cell, MAXENTITIES> entityCells { };
+    std::array<uint32_t, Capacity> entityIndexes { };
+    std::array<Cell, Capacity> entityCells { };
 
     std::array<Entity, CellCount * MainBufferSize + ExtraBufferCount * ExtraBufferSize> buffer { };
     std::array<std::uint8_t, CellCount + ExtraBufferCount> entityCount { };
@@ -1,6 +1,6 @@
 #pragma once
 
-template<typename T>
+template<typename T, uint32_t Capacity>
 class ComponentCollectionCache
 {
 public:
@@ -9,9 +9,10 @@ public:
     inline void Initialize()
     {
         filled = false;
+        data.Initialize();
     }
 
-    inline void Cache(ComponentCollection<T>* collection)
+    inline void Cache(const ComponentCollection<T, Capacity>* collection)
     {
         filled = true;
         data.Overwrite(collection);
@@ -19,7 +20,7 @@ public:
 
     inline bool TryGetTransform(Entity entity, T& result)
     {
-        if (!filled) return false;
+        if (!filled || !data.HasComponent(entity)) return false;
 
         result = data.GetComponent(entity);
         return true;
@@ -32,5 +33,5 @@ public:
 
 private:
     bool filled;
-    ComponentCollection<T> data;
+    ComponentCollection<T, Capacity> data;
 };
\ No newline at end of file
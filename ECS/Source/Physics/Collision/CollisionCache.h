@@ -3,6 +3,9 @@
 #include "ContactPair.h"
 #include "../../ECS/ECSSettings.h"
 
+#include <algorithm>
+#include <array>
+#include <span>
 #include <vector>
 
 class CollisionCache
@@ -14,6 +17,8 @@ public:
         rigidBodyDataCache.resize(frameDepth);
         collisionPairData.resize(frameDepth);
         collisionData.resize(frameDepth);
+        generationCache.resize(frameDepth);
+        generationCounts.resize(frameDepth, 0);
 
         //Initialize caches
         for (FrameNumber i = 0; i < frameDepth; ++i)
@@ -77,16 +82,24 @@ public:
 
     //Caching
 
-    inline void CacheTransformCollection(ComponentCollection<Transform>* transformCollection)
+    inline void CacheTransformCollection(PhysicsComponentCollection<Transform>* transformCollection)
     {
         transformCache[currentIndex].Cache(transformCollection);
     }
 
-    inline void CacheRigidBodyDataCollection(ComponentCollection<RigidBodyData>* rigidBodyDataCollection)
+    inline void CacheRigidBodyDataCollection(PhysicsComponentCollection<RigidBodyData>* rigidBodyDataCollection)
     {
         rigidBodyDataCache[currentIndex].Cache(rigidBodyDataCollection);
     }
 
+    ///Caches the generations of the entities, so an entity of the cached frame can be distinguished from a new entity with the same ID
+    ///Only the generations of the used entity IDs are copied, IDs above them did not exist in the cached frame
+    inline void CacheGenerations(std::span<const EntityGeneration> generations)
+    {
+        std::copy(generations.begin(), generations.end(), generationCache[currentIndex].begin());
+        generationCounts[currentIndex] = static_cast<uint32_t>(generations.size());
+    }
+
     inline void CacheCollisionPair(EntityPair entityPair)
     {
         collisionPairData[currentIndex].Cache(entityPair);
@@ -107,6 +120,12 @@ public:
         return transformCache[currentIndex].TryGetTransform(entity, transform);
     }
 
+    ///Checks whether the entity is the same entity as in the cached frame
+    inline bool IsCachedEntity(EntityHandle handle) const
+    {
+        return handle.Index < generationCounts[currentIndex] && generationCache[currentIndex][handle.Index] == handle.Generation;
+    }
+
     inline bool TryGetRigidBodyData(Entity entity, RigidBodyData& result)
     {
         return rigidBodyDataCache[currentIndex].TryGetTransform(entity, result);
@@ -151,6 +170,8 @@ private:
     std::vector<CollisionPairCache> collisionPairData;
     std::vector<CollisionResultCache> collisionData;
     std::vector<SolverCache> solverCache;
+    std::vector<std::array<EntityGeneration, MaxPhysicsEntities>> generationCache;
+    std::vector<uint32_t> generationCounts;
 
     FrameNumber frameDepth;         //Determines the count of the caches
     FrameNumber oldestFrame;        //Oldest frame where the input it still saved
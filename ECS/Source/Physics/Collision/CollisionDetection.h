@@ -73,8 +73,8 @@ public:
             assert(circleColliderCollection->HasComponent(entity2) && "Collider type of rigidBody does not have the correct collider (Circle) attached");
 
             //Get the components
-            CircleCollider& circleCollider1 = circleColliderCollection->GetComponent(entity1);
-            CircleCollider& circleCollider2 = circleColliderCollection->GetComponent(entity2);
+            const CircleCollider& circleCollider1 = circleColliderCollection->GetComponent(entity1);
+            const CircleCollider& circleCollider2 = circleColliderCollection->GetComponent(entity2);
 
             //Perform AABB check, to test if entities are able to collide
             if (!circleCollider1.GetAABB(transform1, transformMeta1).Overlaps(circleCollider2.GetAABB(transform2, transformMeta2))) return false;
@@ -101,7 +101,7 @@ public:
             assert(boxColliderCollection->HasComponent(entity2) && "Collider type of rigidBody does not have the correct collider (Box) attached");
 
             //Get the components
-            CircleCollider& circleCollider1 = circleColliderCollection->GetComponent(entity1);
+            const CircleCollider& circleCollider1 = circleColliderCollection->GetComponent(entity1);
             BoxCollider& boxCollider2 = boxColliderCollection->GetComponent(entity2);
 
             //Perform AABB check, to test if entities are able to collide
@@ -117,7 +117,7 @@ public:
             assert(polygonColliderCollection->HasComponent(entity2) && "Collider type of rigidBody does not have the correct collider (Polygon) attached");
 
             //Get the components
-            CircleCollider& circleCollider1 = circleColliderCollection->GetComponent(entity1);
+            const CircleCollider& circleCollider1 = circleColliderCollection->GetComponent(entity1);
             PolygonCollider& polygonCollider2 = polygonColliderCollection->GetComponent(entity2);
 
             //Perform AABB check, to test if entities are able to collide
@@ -609,9 +609,9 @@ private:
       }
 
 private:
-      ComponentCollection<CircleCollider>* circleColliderCollection;
-      ComponentCollection<BoxCollider>* boxColliderCollection;
-      ComponentCollection<PolygonCollider>* polygonColliderCollection;
+      PhysicsComponentCollection<CircleCollider>* circleColliderCollection;
+      PhysicsComponentCollection<BoxCollider>* boxColliderCollection;
+      PhysicsComponentCollection<PolygonCollider>* polygonColliderCollection;
 };
 
 //todo: validate shapes with ccw
\ No newline at end of file
@@ -5,9 +5,12 @@
 #include "Transform.h"
 #include "TransformMeta.h"
 
+//The radius never changes after the collider has been created, so the collider is not copied again by snapshots
 class CircleCollider
 {
 public:
+    static constexpr bool Immutable = true;
+
     inline CircleCollider() noexcept = default;
 
     constexpr inline explicit CircleCollider(Fixed16_16 _radius) : Radius(_radius) { }
@@ -22,7 +25,7 @@ public:
         return Radius;
     }
 
-    const AABB& GetAABB(Transform& transform, TransformMeta& transformMeta)
+    const AABB& GetAABB(Transform& transform, TransformMeta& transformMeta) const
     {
         if (transform.AABBUpdateRequired)
         {
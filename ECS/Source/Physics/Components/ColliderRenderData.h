@@ -2,8 +2,11 @@
 
 #include "../../Math/Stream.h"
 
+//The color is set when the entity is created and is not copied again by snapshots
 struct ColliderRenderData
 {
+    static constexpr bool Immutable = true;
+
     uint8_t R, G, B;
 
     inline ColliderRenderData() noexcept = default;
@@ -0,0 +1,4 @@
+#pragma once
+
+//Tag for rigid bodies that never move. Tags have no data and are only stored in the signature of the entity
+struct StaticBody { };
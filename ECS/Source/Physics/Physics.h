@@ -22,22 +22,34 @@ using SolverCache = SortedMapArray<EntityPair, VelocityData, PhysicsIterations,
 //Components
 #include "PhysicsComponents.h"
 
-using PhysicsComponentManager = ComponentManager<PhysicsComponents>;
+using PhysicsComponentManager = ComponentManager<PhysicsComponents, MaxPhysicsEntities>;
+template<typename T>
+using PhysicsComponentCollection = ComponentCollection<T, MaxPhysicsEntities>;
+template<typename... T>
+using PhysicsView = ComponentView<MaxPhysicsEntities, T...>;
+template<typename... T>
+using PhysicsGroup = OwningGroup<MaxPhysicsEntities, T...>;
 static constexpr uint8_t PhysicsComponentCount = PhysicsComponentManager::GetComponentCount();
 using PhysicsSignature = std::bitset<PhysicsComponentCount>;
 
 //Cache
 #include "Cache/ComponentCollectionCache.h"
-using TransformCache = ComponentCollectionCache<Transform>;
-using RigidBodyDataCache = ComponentCollectionCache<RigidBodyData>;
+using TransformCache = ComponentCollectionCache<Transform, MaxPhysicsEntities>;
+using RigidBodyDataCache = ComponentCollectionCache<RigidBodyData, MaxPhysicsEntities>;
 #include "Collision/CollisionCache.h"
 #include "Collision/PhysicsCache.h"
 
+//Resources
+#include "PhysicsResources.h"
+
 //Systems
 #include "PhysicsSystems.h"
 
-using PhysicsSystemManager = SystemManager<PhysicsComponents, PhysicsSystems>;
-using PhysicsLayer = Layer<PhysicsComponents, PhysicsSystems>;
+using PhysicsSystemManager = SystemManager<PhysicsComponents, PhysicsSystems, MaxPhysicsEntities>;
+using PhysicsLayer = Layer<PhysicsComponents, PhysicsSystems, MaxPhysicsEntities, StorageMode::SparseSet, PhysicsResources>;
+using PhysicsCommandBuffer = CommandBuffer<PhysicsComponents, MaxPhysicsEntities>;
+using PhysicsPrefab = Prefab<PhysicsComponents>;
+using PhysicsScheduler = SystemScheduler<PhysicsComponents>;
 
 //Utility
 #include "PhysicsUtils.h"
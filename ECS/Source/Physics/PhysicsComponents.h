@@ -8,5 +8,6 @@
 #include "Components/PolygonCollider.h"
 #include "Components/ColliderRenderData.h"
 #include "Components/Movable.h"
+#include "Components/StaticBody.h"
 
-using PhysicsComponents = ComponentList<Transform, TransformMeta, RigidBodyData, CircleCollider, BoxCollider, PolygonCollider, ColliderRenderData, Movable>;
\ No newline at end of file
+using PhysicsComponents = ComponentList<Transform, TransformMeta, RigidBodyData, CircleCollider, BoxCollider, PolygonCollider, ColliderRenderData, Movable, StaticBody>;
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <random>
+
+//Resources are the state of the physics layer that does not belong to an entity. They are saved and restored together with the entities
+
+//The frame the physics world is simulating
+struct WorldFrame
+{
+    FrameNumber Number;
+};
+
+//Generator for the random objects that are spawned in the physics world
+struct WorldRandom
+{
+    std::mt19937 Generator;
+};
+
+using PhysicsResources = ResourceList<WorldFrame, WorldRandom, PhysicsCache>;
@@ -2,12 +2,17 @@
 
 #include "../Math/FixedTypes.h"
 
+static constexpr uint32_t MaxPhysicsEntities = 500;   //Entity capacity of the physics layer
 constexpr uint8_t PhysicsIterations = 5;
 static constexpr uint32_t MaxCollisionCount = 500;
 
 constexpr int64_t VelocityEpsilon = (Fixed16_16(1) / Fixed16_16(1000)).GetValueIntermediate();
 constexpr Fixed16_16 AngularVelocityEpsilon = Fixed16_16(1) / Fixed16_16(100);
 
+//Incremental sorting of the rigid bodies by grid cell to keep bodies that are close to each other close in memory
+static constexpr uint32_t SortSwapsPerFrame = 32;
+constexpr Fixed16_16 SortCellSize = Fixed16_16(10);
+
 constexpr  Vector2 Gravity = Vector2(Fixed16_16(0), Fixed16_16(-10));
 
 using CollisionHash = std::uint32_t; //TODO
@@ -1,9 +1,10 @@
 #pragma once
 
 #include "Systems/RigidBody.h"
+#include "Systems/IntegrationSystem.h"
 #include "Systems/CircleColliderRenderer.h"
 #include "Systems/BoxColliderRenderer.h"
 #include "Systems/PolygonColliderRenderer.h"
 #include "Systems/MovingSystem.h"
 
-using PhysicsSystems = SystemList<RigidBody, CircleColliderRenderer, BoxColliderRenderer, PolygonColliderRenderer, MovingSystem>;
\ No newline at end of file
+using PhysicsSystems = SystemList<RigidBody, IntegrationSystem, CircleColliderRenderer, BoxColliderRenderer, PolygonColliderRenderer, MovingSystem>;
\ No newline at end of file
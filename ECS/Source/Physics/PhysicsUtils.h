@@ -2,29 +2,90 @@
 
 #include "PhysicsComponents.h"
 
+#include <span>
+#include <vector>
+
 class PhysicsUtils
 {
 public:
-    static Entity CreateCircle(PhysicsLayer& layer, const Vector2& position, const Fixed16_16& radius, RigidBodyType shape = Dynamic, Fixed16_16 density = Fixed16_16(1), uint8_t r = 255, uint8_t g = 255, uint8_t b = 255)
+    //Prefabs hold the components of a body at the origin with precomputed mass and inertia, so many bodies can be created with Instantiate
+    static PhysicsPrefab CreateCirclePrefab(const Fixed16_16& radius, RigidBodyType shape = Dynamic, Fixed16_16 density = Fixed16_16(1), uint8_t r = 255, uint8_t g = 255, uint8_t b = 255)
     {
-        Entity entity = layer.CreateEntity();
+        PhysicsPrefab prefab;
+        prefab.Set(Transform(Vector2(0, 0), Fixed16_16(0)));
+        prefab.Set(TransformMeta(Circle, shape));
+        prefab.Set(CircleCollider(radius));
+
+        if (shape == Static)
+        {
+            SetStaticBody(prefab);
+        }
+        else
+        {
+            prefab.Set(RigidBodyData::CreateCircleRigidBody(radius, density, Fixed16_16(0, 5), Fixed16_16(0, 8), Fixed16_16(0, 4)));
+        }
 
-        layer.AddComponent(entity, Transform(position, Fixed16_16(0)));
-        layer.AddComponent(entity, TransformMeta(Circle, shape));
-        layer.AddComponent(entity, CircleCollider(radius));
+        prefab.Set(ColliderRenderData(r, g, b));
+        return prefab;
+    }
+
+    static PhysicsPrefab CreateBoxPrefab(const Fixed16_16& width, const Fixed16_16& height, RigidBodyType shape = Dynamic, Fixed16_16 density = Fixed16_16(1), uint8_t r = 255, uint8_t g = 255, uint8_t b = 255)
+    {
+        PhysicsPrefab prefab;
+        prefab.Set(Transform(Vector2(0, 0), Fixed16_16(0)));
+        prefab.Set(TransformMeta(Box, shape));
+        prefab.Set(BoxCollider(width, height));
 
         if (shape == Static)
         {
-            layer.AddComponent(entity, RigidBodyData::CreateStaticRigidBody(Fixed16_16(0, 8), Fixed16_16(0, 4)));
+            SetStaticBody(prefab);
         }
         else
         {
-            layer.AddComponent(entity, RigidBodyData::CreateCircleRigidBody(radius, density, Fixed16_16(0, 5), Fixed16_16(0, 8), Fixed16_16(0, 4)));
+            prefab.Set(RigidBodyData::CreateBoxRigidBody(width, height, density, Fixed16_16(0, 5), Fixed16_16(0, 8), Fixed16_16(0, 4)));
+        }
+
+        prefab.Set(ColliderRenderData(r, g, b));
+        return prefab;
+    }
+
+    static PhysicsPrefab CreatePolygonPrefab(const std::vector<Vector2>& vertices, RigidBodyType shape = Dynamic, Fixed16_16 density = Fixed16_16(1), uint8_t r = 255, uint8_t g = 255, uint8_t b = 255)
+    {
+        PhysicsPrefab prefab;
+        prefab.Set(Transform(Vector2(0, 0), Fixed16_16(0)));
+        prefab.Set(TransformMeta(Convex, shape));
+        prefab.Set(PolygonCollider(vertices));
+
+        if (shape == Static)
+        {
+            SetStaticBody(prefab);
+        }
+        else
+        {
+            prefab.Set(RigidBodyData::CreatePolygonRigidBody(vertices, density, Fixed16_16(0, 5), Fixed16_16(0, 8), Fixed16_16(0, 4)));
+        }
+
+        prefab.Set(ColliderRenderData(r, g, b));
+        return prefab;
+    }
+
+    //Creates a body of the prefab at every position and writes the entities into entities
+    static void InstantiateAt(PhysicsLayer& layer, const PhysicsPrefab& prefab, std::span<const Vector2> positions, std::vector<Entity>& entities)
+    {
+        layer.Instantiate(prefab, static_cast<uint32_t>(positions.size()), entities);
+
+        for (uint32_t i = 0; i < positions.size(); ++i)
+        {
+            layer.GetComponent<Transform>(entities[i]) = Transform(positions[i], Fixed16_16(0));
         }
+    }
 
-        layer.AddComponent(entity, ColliderRenderData(r, g, b));
+    static Entity CreateCircle(PhysicsLayer& layer, const Vector2& position, const Fixed16_16& radius, RigidBodyType shape = Dynamic, Fixed16_16 density = Fixed16_16(1), uint8_t r = 255, uint8_t g = 255, uint8_t b = 255)
+    {
+        PhysicsPrefab prefab = CreateCirclePrefab(radius, shape, density, r, g, b);
+        prefab.Set(Transform(position, Fixed16_16(0)));
 
-        return entity;
+        return layer.Instantiate(prefab);
     }
 
     static Entity CreateRandomCircleFromPosition(PhysicsLayer& layer, std::mt19937& numberGenerator, const Vector2& position)
@@ -42,24 +103,10 @@ public:
 
     static Entity CreateBox(PhysicsLayer& layer, const Vector2& position, const Fixed16_16& width, const Fixed16_16& height, RigidBodyType shape = Dynamic, Fixed16_16 density = Fixed16_16(1), uint8_t r = 255, uint8_t g = 255, uint8_t b = 255)
     {
-        Entity entity = layer.CreateEntity();
-
-        layer.AddComponent(entity, Transform(position, Fixed16_16(0)));
-        layer.AddComponent(entity, TransformMeta(Box, shape));
-        layer.AddComponent(entity, BoxCollider(width, height));
-
-        if (shape == Static)
-        {
-            layer.AddComponent(entity, RigidBodyData::CreateStaticRigidBody(Fixed16_16(0, 8), Fixed16_16(0, 4)));
-        }
-        else
-        {
-            layer.AddComponent(entity, RigidBodyData::CreateBoxRigidBody(width, height, density, Fixed16_16(0, 5), Fixed16_16(0, 8), Fixed16_16(0, 4)));
-        }
+        PhysicsPrefab prefab = CreateBoxPrefab(width, height, shape, density, r, g, b);
+        prefab.Set(Transform(position, Fixed16_16(0)));
 
-        layer.AddComponent(entity, ColliderRenderData(r, g, b));
-
-        return entity;
+        return layer.Instantiate(prefab);
     }
 
     static Entity CreateRandomBoxFromPosition(PhysicsLayer& layer, std::mt19937& numberGenerator, const Vector2& position)
@@ -77,24 +124,10 @@ public:
 
     static Entity CreatePolygon(PhysicsLayer& layer, const Vector2& position, const std::vector<Vector2>& vertices, RigidBodyType shape = Dynamic, Fixed16_16 density = Fixed16_16(1), uint8_t r = 255, uint8_t g = 255, uint8_t b = 255)
     {
-        Entity entity = layer.CreateEntity();
-
-        layer.AddComponent(entity, Transform(position, Fixed16_16(0)));
-        layer.AddComponent(entity, TransformMeta(Convex, shape));
-        layer.AddComponent(entity, PolygonCollider(vertices));
+        PhysicsPrefab prefab = CreatePolygonPrefab(vertices, shape, density, r, g, b);
+        prefab.Set(Transform(position, Fixed16_16(0)));
 
-        if (shape == Static)
-        {
-            layer.AddComponent(entity, RigidBodyData::CreateStaticRigidBody(Fixed16_16(0, 8), Fixed16_16(0, 4)));
-        }
-        else
-        {
-            layer.AddComponent(entity, RigidBodyData::CreatePolygonRigidBody(vertices, density, Fixed16_16(0, 5), Fixed16_16(0, 8), Fixed16_16(0, 4)));
-        }
-
-        layer.AddComponent(entity, ColliderRenderData(r, g, b));
-
-        return entity;
+        return layer.Instantiate(prefab);
     }
 
     static Entity CreateRandomPolygonFromPosition(PhysicsLayer& layer, std::mt19937& numberGenerator, const Vector2& position)
@@ -138,4 +171,11 @@ public:
         std::uniform_int_distribution<unsigned int> randomColor(0, 255);
         return static_cast<uint8_t>(randomColor(numberGenerator));
     }
+
+private:
+    static void SetStaticBody(PhysicsPrefab& prefab)
+    {
+        prefab.Set(RigidBodyData::CreateStaticRigidBody(Fixed16_16(0, 8), Fixed16_16(0, 4)));
+        prefab.Set(StaticBody());
+    }
 };
\ No newline at end of file
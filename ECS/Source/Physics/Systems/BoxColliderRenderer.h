@@ -7,24 +7,17 @@ class BoxColliderRenderer
 public:
     using RequiredComponents = ComponentList<Transform, BoxCollider, ColliderRenderData>;
 
-    explicit BoxColliderRenderer(PhysicsComponentManager& componentManager)
+    explicit BoxColliderRenderer(PhysicsComponentManager& componentManager) :
+        renderView(componentManager.View<Transform, BoxCollider, const ColliderRenderData>()),
+        debugView(componentManager.View<Transform, TransformMeta, BoxCollider, const ColliderRenderData>())
     {
-        transformCollection = componentManager.GetComponentCollection<Transform>();
-        transformMetaCollection = componentManager.GetComponentCollection<TransformMeta>();
-        boxColliderCollection = componentManager.GetComponentCollection<BoxCollider>();
-        colliderRenderDataCollection = componentManager.GetComponentCollection<ColliderRenderData>();
-
         Entities.Initialize();
     }
 
     void Render() const
     {
-        for (const Entity& entity : Entities)
+        renderView.ForEach([](Entity, Transform& transform, BoxCollider& boxCollider, const ColliderRenderData& colliderRenderData)
         {
-            Transform& transform = transformCollection->GetComponent(entity);
-            BoxCollider& boxCollider = boxColliderCollection->GetComponent(entity);
-            ColliderRenderData& colliderRenderData = colliderRenderDataCollection->GetComponent(entity);
-
             //Draw filled rectangle
             glColor3ub(colliderRenderData.R, colliderRenderData.G, colliderRenderData.B);
 
@@ -46,19 +39,13 @@ public:
                 glVertex2f(vertex.X.ToFloating<float>(), vertex.Y.ToFloating<float>());
             }
             glEnd();
-        }
+        });
     }
 
     void RenderDebugOverlay() const
     {
-        for (const Entity& entity : Entities)
+        debugView.ForEach([](Entity, Transform& transform, TransformMeta& transformMeta, BoxCollider& boxCollider, const ColliderRenderData&)
         {
-            if (!transformMetaCollection->HasComponent(entity)) continue;
-
-            Transform& transform = transformCollection->GetComponent(entity);
-            TransformMeta& transformMeta = transformMetaCollection->GetComponent(entity);
-            BoxCollider& boxCollider = boxColliderCollection->GetComponent(entity);
-
             if (transformMeta.Active)
             {
                 glColor3ub(128, 128, 128);
@@ -78,15 +65,13 @@ public:
             glVertex2f(boundingBox.Max.X.ToFloating<float>(), boundingBox.Min.Y.ToFloating<float>());
 
             glEnd();
-        }
+        });
     }
 
 private:
-    ComponentCollection<Transform>* transformCollection;
-    ComponentCollection<TransformMeta>* transformMetaCollection;        //Only for debug todo: remove reference in release build
-    ComponentCollection<BoxCollider>* boxColliderCollection;
-    ComponentCollection<ColliderRenderData>* colliderRenderDataCollection;
+    PhysicsView<Transform, BoxCollider, const ColliderRenderData> renderView;
+    PhysicsView<Transform, TransformMeta, BoxCollider, const ColliderRenderData> debugView;   //Only for debug todo: remove in release build
 
 public:
-    EntitySet<MAXENTITIES> Entities;
+    EntitySet<MaxPhysicsEntities> Entities;
 };
\ No newline at end of file
@@ -7,13 +7,10 @@ class CircleColliderRenderer
 public:
     using RequiredComponents = ComponentList<Transform, CircleCollider, ColliderRenderData>;
 
-    explicit CircleColliderRenderer(PhysicsComponentManager& componentManager)
+    explicit CircleColliderRenderer(PhysicsComponentManager& componentManager) :
+        renderView(componentManager.View<Transform, const CircleCollider, const ColliderRenderData>()),
+        debugView(componentManager.View<Transform, TransformMeta, const CircleCollider, const ColliderRenderData>())
     {
-        transformCollection = componentManager.GetComponentCollection<Transform>();
-        transformMetaCollection = componentManager.GetComponentCollection<TransformMeta>();
-        circleColliderCollection = componentManager.GetComponentCollection<CircleCollider>();
-        colliderRenderDataCollection = componentManager.GetComponentCollection<ColliderRenderData>();
-
         Entities.Initialize();
     }
 
@@ -22,12 +19,8 @@ public:
         glEnable(GL_LINE_SMOOTH);
         glEnable(GL_POLYGON_SMOOTH);
 
-        for (const Entity& entity : Entities)
+        renderView.ForEach([](Entity, Transform& transform, const CircleCollider& circleCollider, const ColliderRenderData& colliderRenderData)
         {
-            Transform& transform = transformCollection->GetComponent(entity);
-            CircleCollider& circleCollider = circleColliderCollection->GetComponent(entity);
-            ColliderRenderData& colliderRenderData = colliderRenderDataCollection->GetComponent(entity);
-
             auto x = transform.Base.Position.X.ToFloating<float>();
             auto y = transform.Base.Position.Y.ToFloating<float>();
             auto radius = circleCollider.GetRadius().ToFloating<float>();
@@ -72,7 +65,7 @@ public:
             glVertex2f(v1.X.ToFloating<float>(), v1.Y.ToFloating<float>());
             glVertex2f(v2.X.ToFloating<float>(), v2.Y.ToFloating<float>());
             glEnd();
-        }
+        });
 
         glDisable(GL_POLYGON_SMOOTH);
         glDisable(GL_LINE_SMOOTH);
@@ -80,14 +73,8 @@ public:
 
     void RenderDebugOverlay() const
     {
-        for (const Entity& entity : Entities)
+        debugView.ForEach([](Entity, Transform& transform, TransformMeta& transformMeta, const CircleCollider& circleCollider, const ColliderRenderData&)
         {
-            if (!transformMetaCollection->HasComponent(entity)) continue;
-
-            Transform& transform = transformCollection->GetComponent(entity);
-            TransformMeta& transformMeta = transformMetaCollection->GetComponent(entity);
-            CircleCollider& circleCollider = circleColliderCollection->GetComponent(entity);
-
             if (transformMeta.Active)
             {
                 glColor3ub(128, 128, 128);
@@ -107,15 +94,13 @@ public:
             glVertex2f(boundingBox.Max.X.ToFloating<float>(), boundingBox.Min.Y.ToFloating<float>());
 
             glEnd();
-        }
+        });
     }
 
 private:
-    ComponentCollection<Transform>* transformCollection;
-    ComponentCollection<TransformMeta>* transformMetaCollection;        //Only for debug todo: remove reference in release build
-    ComponentCollection<CircleCollider>* circleColliderCollection;
-    ComponentCollection<ColliderRenderData>* colliderRenderDataCollection;
+    PhysicsView<Transform, const CircleCollider, const ColliderRenderData> renderView;
+    PhysicsView<Transform, TransformMeta, const CircleCollider, const ColliderRenderData> debugView;   //Only for debug todo: remove in release build
 
 public:
-    EntitySet<MAXENTITIES> Entities;
+    EntitySet<MaxPhysicsEntities> Entities;
 };
\ No newline at end of file
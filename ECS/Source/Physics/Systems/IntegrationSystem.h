@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../../ECS/ECS.h"
+#include "../PhysicsSettings.h"
+
+//Integrates the forces and velocities of the rigid bodies that can move. Static bodies are excluded, so they are never iterated
+class IntegrationSystem
+{
+public:
+    using RequiredComponents = ComponentList<Transform, RigidBodyData>;
+    using ExcludedComponents = ComponentList<StaticBody>;
+
+    explicit IntegrationSystem(PhysicsComponentManager& componentManager) : Group(componentManager.Group<Transform, RigidBodyData>())
+    {
+        Entities.Initialize();
+    }
+
+    void IntegrateForces(Fixed16_16 deltaTime, ThreadPool& threadPool)
+    {
+        Group.ForEachParallel(threadPool, [deltaTime](Entity, Transform&, RigidBodyData& rigidBodyData)
+        {
+            rigidBodyData.Base.Velocity += (Gravity + rigidBodyData.Force * rigidBodyData.InverseMass) * deltaTime;
+            //rigidBodyData.AngularVelocity += deltaTime * rigidBodyData.InverseInertia * rigidBodyData.Torque; //todo
+        });
+    }
+
+    void IntegrateVelocities(Fixed16_16 deltaTime, ThreadPool& threadPool)
+    {
+        Group.ForEachParallel(threadPool, [deltaTime](Entity, Transform& transform, RigidBodyData& rigidBodyData)
+        {
+            transform.MovePosition(rigidBodyData.Base.Velocity * deltaTime);
+            transform.Rotate(rigidBodyData.Base.AngularVelocity * deltaTime);
+
+            rigidBodyData.Force = Vector2(0, 0);
+            //rigidBodyData.Torque = Fixed16_16(0); //todo
+        });
+    }
+
+    //Incrementally sorts the bodies by the grid cell of their position (row by row), does not change the simulation result
+    void SortBodies(uint32_t maxSwaps)
+    {
+        Group.Sort([](Entity, const Transform& transform, const RigidBodyData&)
+        {
+            return std::pair(fpm::floorInt(transform.Base.Position.Y / SortCellSize), fpm::floorInt(transform.Base.Position.X / SortCellSize));
+        }, maxSwaps);
+    }
+
+public:
+    EntitySet<MaxPhysicsEntities> Entities;
+    PhysicsGroup<Transform, RigidBodyData> Group;   //Keeps the components of the moving bodies packed in the same order
+};
@@ -8,22 +8,18 @@ class MovingSystem
 {
 public:
     using RequiredComponents = ComponentList<Transform, Movable>;
+    using ReadComponents = ComponentList<Movable>;
+    using WriteComponents = ComponentList<Transform>;
 
-    explicit MovingSystem(PhysicsComponentManager& componentManager)
+    explicit MovingSystem(PhysicsComponentManager& componentManager) : view(componentManager.View<Transform, const Movable>())
     {
-        transformCollection = componentManager.GetComponentCollection<Transform>();
-        movableCollection = componentManager.GetComponentCollection<Movable>();
-
         Entities.Initialize();
     }
 
-    void Update(Fixed16_16 delta, bool up, bool down, bool left, bool right, bool aPos, bool aNeg)
+    void Update(Fixed16_16 delta, bool up, bool down, bool left, bool right, bool aPos, bool aNeg, ThreadPool& threadPool)
     {
-        for (const Entity& entity : Entities)
+        view.ForEachParallel(threadPool, [=](Entity, Transform& transform, const Movable& movable)
         {
-            Transform& transform = transformCollection->GetComponent(entity);
-            Movable& movable = movableCollection->GetComponent(entity);
-
             Vector2 velocity = Vector2::Zero();
             Fixed16_16 angularVelocity = Fixed16_16(0);
 
@@ -58,13 +54,12 @@ public:
             {
                 transform.Rotate(rotation);
             }
-        }
+        });
     }
 
 private:
-    ComponentCollection<Transform>* transformCollection;
-    ComponentCollection<Movable>* movableCollection;
+    PhysicsView<Transform, const Movable> view;
 
 public:
-    EntitySet<MAXENTITIES> Entities;
+    EntitySet<MaxPhysicsEntities> Entities;
 };
\ No newline at end of file
@@ -7,24 +7,17 @@ class PolygonColliderRenderer
 public:
     using RequiredComponents = ComponentList<Transform, PolygonCollider, ColliderRenderData>;
 
-    explicit PolygonColliderRenderer(PhysicsComponentManager& componentManager)
+    explicit PolygonColliderRenderer(PhysicsComponentManager& componentManager) :
+        renderView(componentManager.View<Transform, PolygonCollider, const ColliderRenderData>()),
+        debugView(componentManager.View<Transform, TransformMeta, PolygonCollider, const ColliderRenderData>())
     {
-        transformCollection = componentManager.GetComponentCollection<Transform>();
-        transformMetaCollection = componentManager.GetComponentCollection<TransformMeta>();
-        polygonColliderCollection = componentManager.GetComponentCollection<PolygonCollider>();
-        colliderRenderDataCollection = componentManager.GetComponentCollection<ColliderRenderData>();
-
         Entities.Initialize();
     }
 
     void Render() const
     {
-        for (const Entity& entity : Entities)
+        renderView.ForEach([](Entity, Transform& transform, PolygonCollider& polygonCollider, const ColliderRenderData& colliderRenderData)
         {
-            Transform& transform = transformCollection->GetComponent(entity);
-            PolygonCollider& polygonCollider = polygonColliderCollection->GetComponent(entity);
-            ColliderRenderData& colliderRenderData = colliderRenderDataCollection->GetComponent(entity);
-
             //Get transformed vertices
             Vector2Span vertices = polygonCollider.GetTransformedVertices(transform);
 
@@ -53,19 +46,13 @@ public:
             glColor3ub(255, 255, 255);
             glVertex2f(transform.Base.Position.X.ToFloating<float>(), transform.Base.Position.Y.ToFloating<float>());
             glEnd();
-        }
+        });
     }
 
     void RenderDebugOverlay() const
     {
-        for (const Entity& entity : Entities)
+        debugView.ForEach([](Entity, Transform& transform, TransformMeta& transformMeta, PolygonCollider& polygonCollider, const ColliderRenderData&)
         {
-            if (!transformMetaCollection->HasComponent(entity)) continue;
-
-            Transform& transform = transformCollection->GetComponent(entity);
-            TransformMeta& transformMeta = transformMetaCollection->GetComponent(entity);
-            PolygonCollider& polygonCollider = polygonColliderCollection->GetComponent(entity);
-
             if (transformMeta.Active)
             {
                 glColor3ub(128, 128, 128);
@@ -85,15 +72,13 @@ public:
             glVertex2f(boundingBox.Max.X.ToFloating<float>(), boundingBox.Min.Y.ToFloating<float>());
 
             glEnd();
-        }
+        });
     }
 
 private:
-    ComponentCollection<Transform>* transformCollection;
-    ComponentCollection<TransformMeta>* transformMetaCollection;        //Only for debug todo: remove reference in release build
-    ComponentCollection<PolygonCollider>* polygonColliderCollection;
-    ComponentCollection<ColliderRenderData>* colliderRenderDataCollection;
+    PhysicsView<Transform, PolygonCollider, const ColliderRenderData> renderView;
+    PhysicsView<Transform, TransformMeta, PolygonCollider, const ColliderRenderData> debugView;   //Only for debug todo: remove in release build
 
 public:
-    EntitySet<MAXENTITIES> Entities;
+    EntitySet<MaxPhysicsEntities> Entities;
 };
\ No newline at end of file
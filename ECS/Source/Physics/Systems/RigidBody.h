@@ -5,12 +5,15 @@
 #include "../Collision/CollisionDetection.h"
 
 #include <immintrin.h>
+#include <span>
+#include <utility>
 #include <vector>
 
 class RigidBody
 {
 public:
     using RequiredComponents = ComponentList<Transform, TransformMeta, RigidBodyData>;
+    using WriteComponents = ComponentList<Transform, TransformMeta, RigidBodyData, CircleCollider, BoxCollider, PolygonCollider>; //Colliders cache their transformed vertices during the collision detection
 
     explicit RigidBody(PhysicsComponentManager& componentManager) : collisionDetection(componentManager), useCache(false) //TODO: Static objects should not need to have a rigidBody
     {
@@ -23,7 +26,6 @@ public:
 
         collisionCache = nullptr;
         physicsCache = nullptr;
-
         Entities.Initialize();
     }
 
@@ -33,9 +35,12 @@ public:
         physicsCache = pPhysicsCache;
     }
 
-    void HandleCollisions(FrameNumber frame)
+    ///The generations of the used entity IDs of the layer key the caches with entity handles, so cached pairs of destroyed entities are never reused
+    ///They are valid until the next structural change of the layer, which does not happen during the physics step
+    void HandleCollisions(FrameNumber frame, std::span<const EntityGeneration> pGenerations)
     {
         assert(collisionCache && "CollisionCache is null");
+        generations = pGenerations;
 
         //Update & Validate collision cache
         useCache = collisionCache->UpdateFrame(frame);
@@ -46,6 +51,7 @@ public:
         //Setup transform from cache
         SetupEntityTransforms(useCache);
         collisionCache->CacheTransformCollection(transformCollection);
+        collisionCache->CacheGenerations(generations);
         //collisionCache->CacheRigidBodyDataCollection(rigidBodyDataCollection);
 
         for (Entity* it1 = Entities.begin(); it1 != Entities.end(); ++it1)
@@ -61,7 +67,7 @@ public:
                 //Entity pairs should be ordered
 
                 Transform& transform2 = transformCollection->GetComponent(entity2);
-                EntityPair entityPair = EntityPair::Make(entity1, entity2);
+                EntityPair entityPair = EntityPair::Make(GetHandle(entity1), GetHandle(entity2));
 
                 //Check if collision already occurred in the past
                 if (useCache && !transform1.Changed && !transform2.Changed)
@@ -89,6 +95,7 @@ public:
                 ContactPair contactPair = ContactPair();    //Value initialization to give the impulses zero values
                 if (collisionDetection.DetectCollision(entity1, entity2, transform1, transform2, transformMeta1, transformMeta2, contactPair))
                 {
+                    contactPair.EntityKey = EntityPair::Make(GetHandle(contactPair.Entity1), GetHandle(contactPair.Entity2));
                     SetupContactPair(contactPair, rigidBodyData1, rigidBodyData2);
                     ContactPairs.emplace_back(contactPair);
                     collisionCache->CacheCollisionPair(entityPair);
@@ -108,7 +115,7 @@ public:
             Transform cachedTransform;
             for (const Entity& entity : Entities)
             {
-                if (collisionCache->TryGetTransform(entity, cachedTransform))
+                if (collisionCache->TryGetTransform(entity, cachedTransform) && collisionCache->IsCachedEntity(GetHandle(entity)))
                 {
                     Transform& transform = transformCollection->GetComponent(entity);
                     transform.Changed = transform.Key != cachedTransform.Key;
@@ -150,7 +157,7 @@ public:
         //Apply previous impulses
         if (WarmStarting)
         {
-            EntityPair entityPair = EntityPair::Make(contactPair.Entity1, contactPair.Entity2);
+            EntityPair entityPair = contactPair.EntityKey;
             ImpulseData lastImpulseData;
 
             ImpulseData newImpulseData;
@@ -195,21 +202,6 @@ public:
         }
     }
 
-    void IntegrateForces(Fixed16_16 deltaTime)
-    {
-        for (const Entity& entity : Entities)
-        {
-            TransformMeta& transformMeta = transformMetaCollection->GetComponent(entity);
-
-            if (transformMeta.IsStatic) continue;
-
-            RigidBodyData& rigidBodyData = rigidBodyDataCollection->GetComponent(entity);
-
-            rigidBodyData.Base.Velocity += (Gravity + rigidBodyData.Force * rigidBodyData.InverseMass) * deltaTime;
-            //rigidBodyData.AngularVelocity += deltaTime * rigidBodyData.InverseInertia * rigidBodyData.Torque; //todo
-        }
-    }
-
     static constexpr bool WarmStarting = true;
 
     void SetupContacts()
@@ -315,25 +307,6 @@ public:
         }
     }
 
-    void IntegrateVelocities(Fixed16_16 deltaTime)
-    {
-        for (const Entity& entity : Entities)
-        {
-            TransformMeta& transformMeta = transformMetaCollection->GetComponent(entity);
-
-            if (transformMeta.IsStatic) continue;
-
-            Transform& transform = transformCollection->GetComponent(entity);
-            RigidBodyData& rigidBodyData = rigidBodyDataCollection->GetComponent(entity);
-
-            transform.MovePosition(rigidBodyData.Base.Velocity * deltaTime);
-            transform.Rotate(rigidBodyData.Base.AngularVelocity * deltaTime);
-
-            rigidBodyData.Force = Vector2(0, 0);
-            //rigidBodyData.Torque = Fixed16_16(0); //todo
-        }
-    }
-
     void IntegratePositions()
     {
         physicsCache->ResetImpulses();
@@ -376,7 +349,7 @@ public:
 
             //Cache impulses
             ImpulseData newImpulses;
-            newImpulses.EntityKey = EntityPair::Make(contactPair.Entity1, contactPair.Entity2);
+            newImpulses.EntityKey = contactPair.EntityKey;
             newImpulses.ContactCount = contactPair.ContactCount;
 
             for (uint8_t i = 0; i < contactPair.ContactCount; ++i)
@@ -389,6 +362,12 @@ public:
     }
 
 private:
+    inline EntityHandle GetHandle(Entity entity) const
+    {
+        assert(entity < generations.size() && "Entity was not used when the generations were taken");
+        return EntityHandle { entity, generations[entity] };
+    }
+
     inline Fixed16_16 clamp(Fixed16_16 value, Fixed16_16 min, Fixed16_16 max)
     {
         return fpm::max(min, fpm::min(value, max));
@@ -397,20 +376,21 @@ private:
 private:
     CollisionDetection collisionDetection;
 
-    ComponentCollection<Transform>* transformCollection;
-    ComponentCollection<TransformMeta>* transformMetaCollection;
-    ComponentCollection<RigidBodyData>* rigidBodyDataCollection;
-    ComponentCollection<CircleCollider>* circleColliderCollection;
-    ComponentCollection<BoxCollider>* boxColliderCollection;
-    ComponentCollection<PolygonCollider>* polygonColliderCollection;
+    PhysicsComponentCollection<Transform>* transformCollection;
+    PhysicsComponentCollection<TransformMeta>* transformMetaCollection;
+    PhysicsComponentCollection<RigidBodyData>* rigidBodyDataCollection;
+    PhysicsComponentCollection<CircleCollider>* circleColliderCollection;
+    PhysicsComponentCollection<BoxCollider>* boxColliderCollection;
+    PhysicsComponentCollection<PolygonCollider>* polygonColliderCollection;
 
     //Caching
     CollisionCache* collisionCache;
     PhysicsCache* physicsCache;
+    std::span<const EntityGeneration> generations;
 
     bool useCache;
 
 public:
     std::vector<ContactPair> ContactPairs;
-    EntitySet<MAXENTITIES> Entities;
+    EntitySet<MaxPhysicsEntities> Entities;
 };
\ No newline at end of file